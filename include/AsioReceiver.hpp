@@ -1,20 +1,39 @@
 #pragma once
 
+#include "Constants.hpp"
+#include "HandlerAllocator.hpp"
+#include "TuningProfile.hpp"
+#include <array>
 #include <boost/asio.hpp>
+#include <vector>
 
 class IDataAcceptor;
 
 class AsioReceiver {
 public:
-  AsioReceiver(uint16_t port, std::unique_ptr<IDataAcceptor> dataAcceptor);
+  AsioReceiver(uint16_t port, std::unique_ptr<IDataAcceptor> dataAcceptor,
+               TuningProfile profile = TuningProfile());
 
   void start();
+  // Thread-safe; makes start() return once pending handlers are cancelled.
+  void stop();
+  uint16_t getPort() const;
   size_t getDataUnitsReceived() const;
   size_t getTotalBytesReceived() const;
 
 private:
+  void readNextData();
+  void onDataRead(const boost::system::error_code &error,
+                  std::size_t bytesRead);
+  void readWithKernelTimestamps();
+  void onReadableWithKernelTimestamps(const boost::system::error_code &error);
+
   boost::asio::io_context ioContext_;
   boost::asio::ip::tcp::acceptor acceptor_;
   boost::asio::ip::tcp::socket socket_;
   std::unique_ptr<IDataAcceptor> dataAcceptor_;
-};
\ No newline at end of file
+  TuningProfile profile_;
+  std::array<char, Constants::MaxPacketSize> readBuffer_;
+  std::vector<char> receivedData_;
+  HandlerMemory readHandlerMemory_;
+};
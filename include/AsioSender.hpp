@@ -1,21 +1,134 @@
 #pragma once
 
+#include "HandlerAllocator.hpp"
+#include "SendQueue.hpp"
+#include "TuningProfile.hpp"
 #include <boost/asio.hpp>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 
-class DataProvider;
+class IDataProvider;
+class ITimestampWriter;
 
 class AsioSender {
 public:
+  struct Stats {
+    size_t framesSent = 0;
+    uint64_t bytesSent = 0;
+    size_t droppedFrames = 0;
+    uint64_t droppedBytes = 0;
+    size_t queuedFrames = 0;
+    std::chrono::microseconds interval{0};
+  };
+
+  AsioSender(const std::string &destinationIp, uint16_t destinationPort,
+             std::unique_ptr<IDataProvider> dataProvider,
+             TuningProfile profile = TuningProfile());
+  // Multiplexed mode: frames of every provider are interleaved on one
+  // connection, each prefixed with the provider index as stream ID.
   AsioSender(const std::string &destinationIp, uint16_t destinationPort,
-             std::unique_ptr<DataProvider> dataProvider);
+             std::vector<std::unique_ptr<IDataProvider>> dataProviders,
+             TuningProfile profile = TuningProfile());
+  ~AsioSender();
+
+  void setTxTimestampWriter(std::unique_ptr<ITimestampWriter> writer);
+  void setStreamDelay(uint16_t streamId, std::chrono::milliseconds delay);
+  // Bounds the frames waiting for the socket; see SendQueue for the drop
+  // policy. Both limits are off by default; frames are then paced from the
+  // completion of the previous write, so the queue holds at most one frame
+  // per stream.
+  void setQueuePolicy(size_t capacity, std::chrono::milliseconds maxLatency);
+
+  // Prefetches the first frames of every stream so the transport clock
+  // starts with validated buffers ready to send. Returns frames prefetched.
+  size_t warmUp(size_t framesPerStream);
+  // Time from startTransport() to the first frame handed to the kernel.
+  std::optional<std::chrono::microseconds> getTimeToFirstFrame() const;
 
   void startTransport(
-      std::chrono::milliseconds delay = std::chrono::milliseconds(10));
+      std::chrono::microseconds delay = std::chrono::milliseconds(10));
+  // Thread-safe; cancels pacing timers and closes the connection.
+  void stop();
+  // Thread-safe; sets the frame interval of every stream from the next
+  // frame on, dropping per-stream delays.
+  void setInterval(std::chrono::microseconds interval);
+  // Thread-safe snapshot, refreshed as frames are queued and written.
+  Stats getStats() const;
 
 private:
-  std::unique_ptr<DataProvider> dataProvider_;
+  using WriteHandler = std::function<void(const boost::system::error_code &)>;
+
+  struct Stream {
+    Stream(uint16_t streamId, std::unique_ptr<IDataProvider> provider,
+           boost::asio::io_context &ioContext);
+
+    uint16_t id;
+    std::unique_ptr<IDataProvider> dataProvider;
+    boost::asio::steady_timer timer;
+    HandlerMemory timerHandlerMemory;
+    std::optional<std::chrono::microseconds> delay;
+    std::chrono::steady_clock::time_point nextDue;
+    bool finished = false;
+  };
+
+  struct ZeroCopyFrame {
+    uint32_t sendId;
+    std::shared_ptr<std::vector<char>> frame;
+  };
+
+  struct PendingTxTimestamp {
+    uint64_t lastByteOffset;
+    uint32_t length;
+  };
+
+  void connect(const std::string &destinationIp, uint16_t destinationPort);
+  void processNextData(Stream &stream);
+  void scheduleNextData(Stream &stream);
+  void writeQueuedFrames();
+  void finishIfDone();
+  void publishStats();
+  void finishTransport();
+  void reportTransport();
+  void writeFrame(std::shared_ptr<std::vector<char>> frame,
+                  WriteHandler onWritten);
+  void writeFrameNative(std::shared_ptr<std::vector<char>> frame,
+                        size_t offset, WriteHandler onWritten);
+  void reapErrorQueue();
+  // Waits on a timer, up to the deadline, for zero-copy completions and
+  // TX timestamps still owed by the kernel, then reports.
+  void drainErrorQueue(std::chrono::steady_clock::time_point deadline);
+
+  std::unique_ptr<ITimestampWriter> txTimestampWriter_;
+  TuningProfile profile_;
   boost::asio::io_context ioContext_;
   boost::asio::ip::tcp::socket socket_;
-  boost::asio::steady_timer timer_;
-  std::chrono::milliseconds delay_;
-};
\ No newline at end of file
+  std::chrono::microseconds delay_{std::chrono::milliseconds(10)};
+  std::chrono::steady_clock::time_point transportStartedAt_;
+  std::optional<std::chrono::steady_clock::time_point> firstFrameSentAt_;
+  std::vector<std::unique_ptr<Stream>> streams_;
+  bool multiplexed_;
+  SendQueue sendQueue_;
+  bool paced_ = false;
+  // Unpaced mode: streams whose queued frame has not been written yet, in
+  // queue order.
+  std::deque<Stream *> awaitingWrite_;
+  bool writing_ = false;
+  HandlerMemory writeHandlerMemory_;
+  size_t activeStreams_ = 0;
+
+  std::deque<ZeroCopyFrame> zeroCopyInFlight_;
+  std::deque<PendingTxTimestamp> pendingTxTimestamps_;
+  boost::asio::steady_timer drainTimer_{ioContext_};
+  uint32_t zeroCopySends_ = 0;
+  size_t zeroCopyCopied_ = 0;
+  uint64_t bytesSent_ = 0;
+
+  size_t framesWritten_ = 0;
+  uint64_t bytesWritten_ = 0;
+  mutable std::mutex statsMutex_;
+  Stats stats_;
+};
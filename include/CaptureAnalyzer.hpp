@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Offline verification of captures and timestamp logs. The heavy passes
+// (checksums, frame comparison, log parsing) are split into chunks that run
+// on all cores.
+class CaptureAnalyzer {
+public:
+  struct FrameIndexEntry {
+    uint64_t offset; // of the 4-byte header
+    uint32_t length; // payload length
+  };
+
+  struct FramingResult {
+    std::vector<FrameIndexEntry> frames;
+    uint64_t validBytes = 0;
+    std::string error; // empty when the whole input is well framed
+  };
+
+  struct Divergence {
+    bool identical = true;
+    size_t frameIndex = 0;
+    uint64_t captureOffset = 0;
+    std::string reason;
+  };
+
+  struct TimestampRecord {
+    int64_t microseconds;
+    uint32_t bytes;
+  };
+
+  struct TimingReport {
+    size_t units = 0;
+    uint64_t totalBytes = 0;
+    size_t outOfOrder = 0; // units stamped earlier than a previous one
+    double durationMs = 0;
+    // Percentiles of the inter-arrival interval and of its deviation from
+    // the nominal interval, in the order of Percentiles.
+    std::vector<double> intervalMs;
+    std::vector<double> jitterMs;
+    size_t gapCount = 0;
+    double longestGapMs = 0;
+    size_t longestGapUnit = 0;
+    size_t windowCount = 0;
+    double minWindowMBps = 0;
+    double meanWindowMBps = 0;
+    double maxWindowMBps = 0;
+  };
+
+  static constexpr double Percentiles[] = {0.0, 50.0, 90.0, 99.0, 99.9, 100.0};
+
+  explicit CaptureAnalyzer(unsigned threads = 0);
+
+  FramingResult indexFrames(const char *data, size_t size) const;
+  uint64_t checksum(const char *data, const FramingResult &framing) const;
+  Divergence compareFrames(const char *capture, const FramingResult &captured,
+                           const char *source,
+                           const FramingResult &sourceFraming) const;
+
+  std::vector<TimestampRecord> parseTimestampLog(const char *data,
+                                                 size_t size) const;
+  TimingReport analyzeTiming(const std::vector<TimestampRecord> &records,
+                             std::chrono::microseconds nominalInterval,
+                             std::chrono::milliseconds window) const;
+
+private:
+  unsigned threads_;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// Commit journal of a capture: "<output_file>.journal" holds two fixed-size
+// commit records written alternately, each naming how many bytes of the
+// output file and of its timestamp log hold complete data units. A record
+// is only written after both files are synced up to that point, and is
+// checksummed, so a torn record leaves the previous one intact. Recovery
+// reads both slots and truncates to the newer valid one without looking at
+// the data.
+class CaptureJournal {
+public:
+  static constexpr size_t RecordSizeBytes = 64;
+  static constexpr size_t SlotCount = 2;
+
+  struct Commit {
+    uint64_t sequence = 0;
+    uint64_t frames = 0;
+    uint64_t dataBytes = 0;
+    uint64_t timestampBytes = 0;
+    std::chrono::system_clock::time_point committedAt;
+  };
+
+  struct Recovery {
+    std::optional<Commit> commit; // none: nothing was committed
+    uint64_t dataBytesFound = 0;
+    uint64_t timestampBytesFound = 0;
+    bool truncated = false;
+  };
+
+  // Creates (truncates) the journal of dataFileName.
+  explicit CaptureJournal(const std::string &dataFileName);
+  ~CaptureJournal();
+
+  CaptureJournal(const CaptureJournal &) = delete;
+  CaptureJournal &operator=(const CaptureJournal &) = delete;
+
+  // Writes the next record and syncs the journal. The caller has synced
+  // the data it describes.
+  void commit(uint64_t frames, uint64_t dataBytes, uint64_t timestampBytes);
+  uint64_t getCommitCount() const { return sequence_; }
+
+  static std::string journalPath(const std::string &dataFileName);
+  // Newest valid record of the journal of dataFileName.
+  static std::optional<Commit> readLastCommit(const std::string &dataFileName);
+  // Truncates the capture and its timestamp log to the last commit (both to
+  // zero without one). With dryRun only reports what would be cut.
+  static Recovery recover(const std::string &dataFileName,
+                          const std::string &timestampFileName,
+                          bool dryRun = false);
+
+private:
+  std::string path_;
+  int fd_ = -1;
+  uint64_t sequence_ = 0;
+};
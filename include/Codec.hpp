@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Block compressor for a single frame payload. Codec IDs travel in the low
+// nibble of the frame flags, so every receiver can decode any frame without
+// knowing which codec its sender picked.
+class ICodec {
+public:
+  virtual ~ICodec() = default;
+
+  virtual uint8_t getId() const = 0;
+  virtual const char *getName() const = 0;
+  // Returns the compressed size, or 0 when the output does not fit.
+  virtual size_t compress(const char *source, size_t size, char *destination,
+                          size_t capacity) const = 0;
+  // Returns false on malformed input or a size mismatch.
+  virtual bool decompress(const char *source, size_t size, char *destination,
+                          size_t originalSize) const = 0;
+
+  // Known names are "none", "lz4" and "deflate"; "none" yields nullptr.
+  static std::unique_ptr<ICodec> fromName(const std::string &name);
+  static std::unique_ptr<ICodec> fromId(uint8_t id);
+};
+
+// LZ4 block format, implemented in-tree.
+class Lz4Codec : public ICodec {
+public:
+  static constexpr uint8_t Id = 1;
+
+  uint8_t getId() const override { return Id; }
+  const char *getName() const override { return "lz4"; }
+  size_t compress(const char *source, size_t size, char *destination,
+                  size_t capacity) const override;
+  bool decompress(const char *source, size_t size, char *destination,
+                  size_t originalSize) const override;
+};
+
+// zlib deflate at its fastest level.
+class DeflateCodec : public ICodec {
+public:
+  static constexpr uint8_t Id = 2;
+
+  uint8_t getId() const override { return Id; }
+  const char *getName() const override { return "deflate"; }
+  size_t compress(const char *source, size_t size, char *destination,
+                  size_t capacity) const override;
+  bool decompress(const char *source, size_t size, char *destination,
+                  size_t originalSize) const override;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "DataProvider.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class ICodec;
+class WorkerPool;
+
+// Compresses the data units of an inner provider on a worker pool, a few
+// frames ahead of the pacing clock. A frame that does not shrink by at least
+// MinSavings is sent raw; after a run of such frames the stage stops trying
+// for a while and then probes again.
+class CompressionStage : public IDataProvider {
+public:
+  static constexpr double MinSavings = 0.1;
+  static constexpr size_t PoorFramesBeforeBackoff = 8;
+  static constexpr size_t BackoffFrames = 64;
+
+  struct Stats {
+    size_t frames = 0;
+    size_t compressedFrames = 0;
+    size_t attemptedFrames = 0;
+    uint64_t inputBytes = 0;
+    uint64_t outputBytes = 0;
+    uint64_t attemptedBytes = 0;
+    std::chrono::nanoseconds compressTime{0};
+
+    double ratio() const;
+    double throughputMBps() const; // of compression attempts, per worker
+  };
+
+  CompressionStage(std::unique_ptr<IDataProvider> inner,
+                   std::unique_ptr<ICodec> codec,
+                   std::shared_ptr<WorkerPool> pool, size_t lookahead = 8);
+  ~CompressionStage() override;
+
+  std::optional<std::vector<char>> getNextData() override;
+  size_t prefetch(size_t frames) override;
+
+  const Stats &getStats() const { return stats_; }
+  const ICodec &getCodec() const { return *codec_; }
+
+  // Returns the compressed data unit, or nullopt when it would not save at
+  // least MinSavings of the payload.
+  static std::optional<std::vector<char>>
+  compressFrame(const ICodec &codec, const std::vector<char> &frame);
+
+private:
+  struct Result {
+    std::vector<char> frame;
+    size_t inputSize = 0;
+    bool attempted = false;
+    bool compressed = false;
+    std::chrono::nanoseconds compressTime{0};
+  };
+
+  void fill(size_t depth);
+  void account(const Result &result);
+
+  std::unique_ptr<IDataProvider> inner_;
+  std::unique_ptr<ICodec> codec_;
+  std::shared_ptr<WorkerPool> pool_;
+  size_t lookahead_;
+  std::deque<std::future<Result>> pending_;
+  bool innerFinished_ = false;
+  size_t poorFrames_ = 0;
+  size_t backoffRemaining_ = 0;
+  Stats stats_;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Options file for the binaries: one "key = value" (or bare "key" for
+// switches) per line, '#' starts a comment. Keys are the command-line flags
+// without the leading dashes, so every flag can live in the file.
+class ConfigFile {
+public:
+  // Returns the options of the file as "--key=value" / "--key" arguments.
+  static std::vector<std::string> load(const std::string &fileName);
+
+  // argv without the program name. Options of a --config=<file> argument
+  // come first so that flags given on the command line override them.
+  static std::vector<std::string> expandArguments(int argc, char *argv[]);
+};
@@ -1,6 +1,24 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Constants {
 constexpr auto MaxPacketSize = 16387;
 constexpr auto HeaderSizeBytes = 4;
+constexpr auto StreamIdSizeBytes = 2;
+
+// The top byte of the 4-byte header carries per-frame flags; lengths fit in
+// the lower 24 bits (MaxPacketSize is far below 2^24).
+constexpr uint32_t HeaderLengthMask = 0x00FFFFFF;
+constexpr auto HeaderFlagsShift = 24;
+constexpr uint8_t FlagKeyframe = 0x80;
+// The payload is AES-256-GCM ciphertext | nonce | tag; the header, stream
+// ID and nonce counter are authenticated as associated data.
+constexpr uint8_t FlagEncrypted = 0x40;
+// Low nibble: ID of the codec that compressed the payload, 0 when raw.
+// A compressed payload starts with the 4-byte big-endian original length.
+constexpr uint8_t FlagCodecMask = 0x0F;
+// Unassigned; a header with these set is corrupt.
+constexpr uint8_t FlagReservedMask = 0x30;
+constexpr auto OriginalLengthSizeBytes = 4;
 } // namespace Constants
\ No newline at end of file
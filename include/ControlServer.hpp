@@ -0,0 +1,52 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Local control socket (Unix domain, one command per line) served on its own
+// thread, so commands never wait for the transport. A request is
+// "<command> [args...]"; the reply is the handler's text, or
+// "error: <message>" when it throws, terminated by an empty line. Handlers
+// run on the control thread and must only call thread-safe methods.
+class ControlServer {
+public:
+  using Handler =
+      std::function<std::string(const std::vector<std::string> &args)>;
+
+  explicit ControlServer(std::string socketPath);
+  ~ControlServer();
+
+  ControlServer(const ControlServer &) = delete;
+  ControlServer &operator=(const ControlServer &) = delete;
+
+  void addCommand(const std::string &name, const std::string &usage,
+                  Handler handler);
+  // Binds the socket (replacing a stale one) and starts serving.
+  void start();
+  void stop();
+
+  std::string execute(const std::string &line);
+  const std::string &getPath() const { return socketPath_; }
+
+private:
+  struct Command {
+    std::string usage;
+    Handler handler;
+  };
+  class Session;
+
+  void accept();
+
+  std::string socketPath_;
+  std::mutex commandsMutex_;
+  std::map<std::string, Command> commands_;
+  boost::asio::io_context ioContext_;
+  boost::asio::local::stream_protocol::acceptor acceptor_;
+  std::thread thread_;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "DataAcceptor.hpp"
+#include "Constants.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+class IFrameSink;
+class DataUnitConverter;
+
+// Parses the byte stream in place and passes each data unit to a frame sink
+// while it arrives, instead of buffering it until it is complete. Beyond the
+// receiver's copy of each read, only the header is copied; payload chunks
+// point into the data handed to processRawData.
+class CutThroughAcceptor : public IDataAcceptor {
+public:
+  struct Stats {
+    size_t frames = 0;
+    size_t chunks = 0;
+    // Sum over frames of (last byte arrival - header arrival): how much
+    // earlier the sink could start than with whole-frame delivery.
+    std::chrono::microseconds leadTime{0};
+
+    double chunksPerFrame() const;
+    std::chrono::microseconds averageLeadTime() const;
+  };
+
+  explicit CutThroughAcceptor(std::unique_ptr<IFrameSink> sink);
+  ~CutThroughAcceptor() override;
+
+  void processRawData(const std::vector<char> &rawData) override;
+  void processRawData(const std::vector<char> &rawData,
+                      std::chrono::system_clock::time_point arrivalTime)
+      override;
+  void processRawData(const char *data, size_t size,
+                      std::chrono::system_clock::time_point arrivalTime);
+  size_t getDataUnitsReceived() const override;
+  size_t getTotalBytesReceived() const override;
+
+  // Not synchronised; read once the receiver has stopped.
+  const Stats &getStats() const { return stats_; }
+
+private:
+  std::unique_ptr<IFrameSink> sink_;
+  std::unique_ptr<DataUnitConverter> converter_;
+  std::array<char, Constants::HeaderSizeBytes> header_{};
+  size_t headerBytes_ = 0;
+  bool inFrame_ = false;
+  uint32_t remaining_ = 0;
+  std::chrono::system_clock::time_point frameBeganAt_;
+  Stats stats_;
+  // Atomic so stats can be read while another thread receives.
+  std::atomic<size_t> dataUnitsReceived_{0};
+  std::atomic<size_t> totalBytesReceived_{0};
+};
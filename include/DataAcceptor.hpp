@@ -1,16 +1,28 @@
 #pragma once
 
+#include "WriterRotation.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include <memory>
+#include <optional>
 
 class IDataFile;
 class ITimestampWriter;
 class IDataUnitConverter;
+class ICodec;
+class FrameCipher;
+struct DataUnit;
 
 class IDataAcceptor {
 public:
   virtual ~IDataAcceptor() = default;
   virtual void processRawData(const std::vector<char> &rawData) = 0;
+  virtual void
+  processRawData(const std::vector<char> &rawData,
+                 std::chrono::system_clock::time_point arrivalTime) = 0;
   virtual size_t getDataUnitsReceived() const = 0;
   virtual size_t getTotalBytesReceived() const = 0;
 };
@@ -19,15 +31,42 @@ class DataAcceptor : public IDataAcceptor {
 public:
   DataAcceptor(std::unique_ptr<IDataFile> videoDataWriter,
                std::unique_ptr<ITimestampWriter> timestampWriter);
+  ~DataAcceptor() override;
 
   void processRawData(const std::vector<char> &rawData) override;
+  void processRawData(const std::vector<char> &rawData,
+                      std::chrono::system_clock::time_point arrivalTime)
+      override;
   size_t getDataUnitsReceived() const override;
   size_t getTotalBytesReceived() const override;
+  size_t getCompressedUnitsReceived() const;
+  size_t getEncryptedUnitsReceived() const;
+
+  // Once a cipher is set, every unit must be encrypted and authenticate.
+  void setCipher(std::unique_ptr<FrameCipher> cipher);
+  // Thread-safe; the next data unit goes to the new writers and the old
+  // ones are closed.
+  void rotate(std::unique_ptr<IDataFile> videoDataWriter,
+              std::unique_ptr<ITimestampWriter> timestampWriter);
 
 private:
+  // Restores the original payload of a unit flagged with a codec ID.
+  void decompress(DataUnit &unit);
+  void decrypt(DataUnit &unit);
+
+  void acceptRawData(
+      const std::vector<char> &rawData,
+      std::optional<std::chrono::system_clock::time_point> arrivalTime);
+
   std::unique_ptr<IDataFile> videoDataWriter_;
   std::unique_ptr<ITimestampWriter> timestampWriter_;
   std::unique_ptr<IDataUnitConverter> converter_;
-  size_t dataUnitsReceived_ = 0;
-  size_t totalBytesReceived_ = 0;
+  std::array<std::unique_ptr<ICodec>, 16> codecs_;
+  std::unique_ptr<FrameCipher> cipher_;
+  WriterRotation rotation_;
+  // Atomic so stats can be read while another thread receives.
+  std::atomic<size_t> compressedUnitsReceived_{0};
+  std::atomic<size_t> encryptedUnitsReceived_{0};
+  std::atomic<size_t> dataUnitsReceived_{0};
+  std::atomic<size_t> totalBytesReceived_{0};
 };
\ No newline at end of file
@@ -10,21 +10,37 @@ public:
   virtual ~IDataFile() = default;
   virtual void writeBinaryData(const std::vector<char> &data) = 0;
   virtual std::optional<std::vector<char>> readNextDataUnit() = 0;
+  // Cut-through writes: a data unit arrives in parts and is made durable as
+  // a whole by finishDataUnit(). By default every part is a full write.
+  virtual void writePartialData(const char *data, size_t size) {
+    writeBinaryData(std::vector<char>(data, data + size));
+  }
+  virtual void finishDataUnit() {}
 };
 
 class DataFile : public IDataFile {
 public:
   enum class Mode { Read, Write };
+  // When written data is handed to the OS: on close (Buffered), after every
+  // data unit (Flush), or flushed and fdatasync'ed to disk (Sync).
+  enum class Durability { Buffered, Flush, Sync };
 
-  DataFile(const std::string &filename, Mode mode = Mode::Read);
+  DataFile(const std::string &filename, Mode mode = Mode::Read,
+           Durability durability = Durability::Flush);
+
+  static Durability durabilityFromName(const std::string &name);
   ~DataFile() override;
 
   void writeBinaryData(const std::vector<char> &data) override;
   std::optional<std::vector<char>> readNextDataUnit() override;
+  void writePartialData(const char *data, size_t size) override;
+  void finishDataUnit() override;
 
 private:
   std::string filename_;
   std::fstream file_;
   Mode mode_;
+  Durability durability_;
+  int syncFd_ = -1;
   size_t bytesWritten_ = 0;
 };
\ No newline at end of file
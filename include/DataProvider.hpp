@@ -1,4 +1,5 @@
 #pragma once
+#include <deque>
 #include <optional>
 #include <memory>
 #include <vector>
@@ -6,13 +7,29 @@
 class IDataFile;
 class DataUnitConverter;
 
-class DataProvider {
+class IDataProvider {
+public:
+  virtual ~IDataProvider() = default;
+  // Returns the next encoded data unit (header + payload).
+  virtual std::optional<std::vector<char>> getNextData() = 0;
+  // Prepares up to `frames` data units ahead of time; returns how many are
+  // ready.
+  virtual size_t prefetch(size_t frames) = 0;
+};
+
+class DataProvider : public IDataProvider {
 public:
   explicit DataProvider(std::unique_ptr<IDataFile> dataFile);
 
-  std::optional<std::vector<char>> getNextData();
+  std::optional<std::vector<char>> getNextData() override;
+  // Reads and validates up to `frames` data units ahead of time; they are
+  // handed out by getNextData() before the file is touched again.
+  size_t prefetch(size_t frames) override;
 
 private:
+  std::optional<std::vector<char>> readNextData();
+
+  std::deque<std::vector<char>> prefetched_;
   std::unique_ptr<IDataFile> dataFile_;
   std::unique_ptr<DataUnitConverter> converter_;
 };
\ No newline at end of file
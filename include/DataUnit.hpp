@@ -5,4 +5,5 @@
 struct DataUnit {
   uint32_t length = 0;
   std::vector<char> data;
+  uint8_t flags = 0;
 };
\ No newline at end of file
@@ -21,6 +21,11 @@ public:
   decodeDataUnit(const std::vector<char> &data) override;
 
   std::optional<uint32_t> decodeHeader(const std::vector<char> &data);
+  std::optional<uint32_t> decodeHeader(const char *data, size_t size);
+  std::optional<uint8_t> decodeFlags(const char *data, size_t size);
+  // Throws when a complete header has reserved flags set or a length no
+  // sender produces, rather than misframing the rest of the stream.
+  void validateHeader(const char *data, size_t size);
 
 private:
   std::vector<char> buffer_;
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "DataProvider.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class FrameCipher;
+
+// Encrypts every data unit of an inner provider in place as it is handed to
+// the sender. Compression, if any, has to run before this stage.
+class EncryptionStage : public IDataProvider {
+public:
+  struct Stats {
+    size_t frames = 0;
+    uint64_t plainBytes = 0;
+    uint64_t overheadBytes = 0;
+    std::chrono::nanoseconds sealTime{0};
+
+    double throughputMBps() const;
+    double microsecondsPerFrame() const;
+  };
+
+  EncryptionStage(std::unique_ptr<IDataProvider> inner,
+                  std::unique_ptr<FrameCipher> cipher);
+  ~EncryptionStage() override;
+
+  std::optional<std::vector<char>> getNextData() override;
+  size_t prefetch(size_t frames) override;
+
+  const Stats &getStats() const { return stats_; }
+
+private:
+  std::unique_ptr<IDataProvider> inner_;
+  std::unique_ptr<FrameCipher> cipher_;
+  Stats stats_;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct DataUnit;
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+// Per-frame AES-256-GCM with a pre-shared key. The payload is encrypted and
+// decrypted where it is, with the nonce and tag appended after it; OpenSSL
+// dispatches to AES-NI/PCLMULQDQ when the CPU has them. The header, the
+// stream ID and the nonce counter are authenticated, so a frame cannot be
+// moved to another stream. A receiver pins the salt of the first frame it
+// authenticates and then only accepts increasing counters, so once a stream
+// runs, frames captured from it or from an earlier session are rejected.
+class FrameCipher {
+public:
+  static constexpr size_t KeySizeBytes = 32;
+  static constexpr size_t NonceSizeBytes = 12;
+  static constexpr size_t TagSizeBytes = 16;
+  static constexpr size_t OverheadBytes = NonceSizeBytes + TagSizeBytes;
+  using Key = std::array<unsigned char, KeySizeBytes>;
+
+  // Both ends of a stream use the same streamId (0 when not multiplexed).
+  explicit FrameCipher(const Key &key, uint16_t streamId = 0);
+  ~FrameCipher();
+  FrameCipher(const FrameCipher &) = delete;
+  FrameCipher &operator=(const FrameCipher &) = delete;
+
+  // Reads a key stored as 32 raw bytes or 64 hex digits.
+  static Key loadKey(const std::string &fileName);
+  static bool hardwareAccelerated();
+
+  // Encrypts the payload of an encoded data unit and sets FlagEncrypted.
+  // Throws once the nonce counter is exhausted.
+  void seal(std::vector<char> &frame);
+  // Decrypts a unit flagged FlagEncrypted; false when authentication fails,
+  // its salt is not the pinned one or its counter does not follow the last
+  // one opened.
+  bool open(DataUnit &unit);
+
+private:
+  void nextNonce(unsigned char *nonce);
+  void writeAssociatedData(unsigned char *out, uint32_t length, uint8_t flags,
+                           const unsigned char *nonce) const;
+
+  EVP_CIPHER_CTX *encryptContext_;
+  EVP_CIPHER_CTX *decryptContext_;
+  // Random per cipher instance, so senders sharing a key never reuse nonces.
+  uint64_t salt_ = 0;
+  uint32_t counter_ = 0;
+  uint16_t streamId_;
+  // Salt of the sending side, pinned by the first authenticated frame.
+  std::optional<uint64_t> openedSalt_;
+  uint32_t openedCounter_ = 0;
+};
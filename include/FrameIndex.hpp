@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CaptureAnalyzer.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+// Offsets of every frame in a recording. It is cached next to the recording
+// as "<file>.idx" and reused while the recording's size and modification
+// time are unchanged, so later runs skip the framing walk.
+class FrameIndex {
+public:
+  using Entry = CaptureAnalyzer::FrameIndexEntry;
+
+  static FrameIndex build(const std::string &filename, const MappedFile &file);
+  // Returns nothing when the index is missing, stale or does not describe
+  // the mapped recording, so it has to be rebuilt.
+  static std::optional<FrameIndex> load(const std::string &filename,
+                                        const MappedFile &file);
+  static FrameIndex loadOrBuild(const std::string &filename,
+                                const MappedFile &file);
+  static std::string indexPath(const std::string &filename);
+
+  // Returns false when the index file could not be written.
+  bool save(const std::string &filename) const;
+
+  size_t size() const { return frames_.size(); }
+  const Entry &operator[](size_t frame) const { return frames_[frame]; }
+  bool wasLoaded() const { return loaded_; }
+
+private:
+  std::vector<Entry> frames_;
+  uint64_t fileSize_ = 0;
+  int64_t modificationTime_ = 0;
+  bool loaded_ = false;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "DataUnit.hpp"
+#include "WriterRotation.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+class IDataFile;
+class ITimestampWriter;
+
+// Receives a data unit while it is still arriving: beginFrame() as soon as
+// the header is in, the payload in the chunks the transport delivered, then
+// endFrame() once the last byte is in. Times are arrival times of the read
+// that carried the header and the last byte.
+class IFrameSink {
+public:
+  virtual ~IFrameSink() = default;
+  virtual void
+  beginFrame(uint32_t length, uint8_t flags,
+             std::chrono::system_clock::time_point arrivalTime) = 0;
+  virtual void frameChunk(const char *data, size_t size) = 0;
+  virtual void endFrame(std::chrono::system_clock::time_point arrivalTime) = 0;
+};
+
+// Writes each unit to the file as it arrives, header first, and logs its
+// timestamp when it completes. Payloads are written as received, so
+// compressed or encrypted units are rejected.
+class FileFrameSink : public IFrameSink {
+public:
+  FileFrameSink(std::unique_ptr<IDataFile> videoDataWriter,
+                std::unique_ptr<ITimestampWriter> timestampWriter);
+  ~FileFrameSink() override;
+
+  void beginFrame(uint32_t length, uint8_t flags,
+                  std::chrono::system_clock::time_point arrivalTime) override;
+  void frameChunk(const char *data, size_t size) override;
+  void endFrame(std::chrono::system_clock::time_point arrivalTime) override;
+
+  // Thread-safe; the next unit to begin goes to the new writers.
+  void rotate(std::unique_ptr<IDataFile> videoDataWriter,
+              std::unique_ptr<ITimestampWriter> timestampWriter);
+
+private:
+  std::unique_ptr<IDataFile> videoDataWriter_;
+  std::unique_ptr<ITimestampWriter> timestampWriter_;
+  DataUnit unit_; // header fields of the unit in flight, no payload
+  WriterRotation rotation_;
+};
+
+// Whole-frame API on top of a cut-through stream: collects the chunks and
+// hands over complete units.
+class FrameAssembler : public IFrameSink {
+public:
+  using FrameHandler = std::function<void(
+      DataUnit &&unit, std::chrono::system_clock::time_point arrivalTime)>;
+
+  explicit FrameAssembler(FrameHandler onFrame);
+
+  void beginFrame(uint32_t length, uint8_t flags,
+                  std::chrono::system_clock::time_point arrivalTime) override;
+  void frameChunk(const char *data, size_t size) override;
+  void endFrame(std::chrono::system_clock::time_point arrivalTime) override;
+
+private:
+  FrameHandler onFrame_;
+  DataUnit unit_;
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Recycled storage for the state of one outstanding asynchronous operation.
+// Send and receive loops have at most one operation of each kind in flight,
+// so after the first frame every handler allocation is served from here.
+class HandlerMemory {
+public:
+  HandlerMemory() = default;
+  HandlerMemory(const HandlerMemory &) = delete;
+  HandlerMemory &operator=(const HandlerMemory &) = delete;
+
+  void *allocate(std::size_t size) {
+    if (!inUse_ && size <= sizeof(storage_)) {
+      inUse_ = true;
+      recycledAllocations_++;
+      return &storage_;
+    }
+    heapAllocations_++;
+    return ::operator new(size);
+  }
+
+  void deallocate(void *pointer) {
+    if (pointer == &storage_) {
+      inUse_ = false;
+    } else {
+      ::operator delete(pointer);
+    }
+  }
+
+  std::size_t getRecycledAllocations() const { return recycledAllocations_; }
+  std::size_t getHeapAllocations() const { return heapAllocations_; }
+
+private:
+  typename std::aligned_storage<1024>::type storage_;
+  bool inUse_ = false;
+  std::size_t recycledAllocations_ = 0;
+  std::size_t heapAllocations_ = 0;
+};
+
+template <typename T> class HandlerAllocator {
+public:
+  using value_type = T;
+
+  explicit HandlerAllocator(HandlerMemory &memory) : memory_(memory) {}
+
+  template <typename U>
+  HandlerAllocator(const HandlerAllocator<U> &other) noexcept
+      : memory_(other.memory_) {}
+
+  T *allocate(std::size_t count) {
+    return static_cast<T *>(memory_.allocate(sizeof(T) * count));
+  }
+
+  void deallocate(T *pointer, std::size_t) { memory_.deallocate(pointer); }
+
+  bool operator==(const HandlerAllocator &other) const noexcept {
+    return &memory_ == &other.memory_;
+  }
+
+  bool operator!=(const HandlerAllocator &other) const noexcept {
+    return &memory_ != &other.memory_;
+  }
+
+private:
+  template <typename> friend class HandlerAllocator;
+
+  HandlerMemory &memory_;
+};
+
+// Wraps a completion handler so Asio allocates its operation state from the
+// given HandlerMemory (picked up through the associated allocator).
+template <typename Handler> class RecyclingHandler {
+public:
+  using allocator_type = HandlerAllocator<Handler>;
+
+  RecyclingHandler(HandlerMemory &memory, Handler handler)
+      : memory_(memory), handler_(std::move(handler)) {}
+
+  allocator_type get_allocator() const noexcept {
+    return allocator_type(memory_);
+  }
+
+  template <typename... Args> void operator()(Args &&...args) {
+    handler_(std::forward<Args>(args)...);
+  }
+
+private:
+  HandlerMemory &memory_;
+  Handler handler_;
+};
+
+template <typename Handler>
+RecyclingHandler<typename std::decay<Handler>::type>
+makeRecyclingHandler(HandlerMemory &memory, Handler &&handler) {
+  return RecyclingHandler<typename std::decay<Handler>::type>(
+      memory, std::forward<Handler>(handler));
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct ImpairmentConfig {
+  std::chrono::microseconds delay{0};
+  std::chrono::microseconds jitter{0}; // uniform in [-jitter, +jitter]
+  uint64_t bandwidthBytesPerSecond = 0; // 0 = unlimited
+  size_t minSegmentBytes = 0;           // 0 = forward reads unsplit
+  size_t maxSegmentBytes = 0;
+  double stallProbability = 0.0; // per segment
+  std::chrono::milliseconds stallDuration{0};
+  // Bytes the link may hold before the sender is pushed back (proxy only).
+  size_t bufferBytes = 256 * 1024;
+  uint32_t seed = 1;
+};
+
+// Decides how a one-way byte stream is cut into segments and when each
+// segment leaves the simulated link. Segment sizes, latencies and stalls are
+// drawn from a seeded RNG per segment, so the cut points in the stream and
+// the delays relative to arrival repeat exactly for the same seed.
+class ImpairmentModel {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Segment {
+    size_t offset; // into the chunk passed to schedule()
+    size_t size;
+    Clock::time_point departure;
+  };
+
+  explicit ImpairmentModel(ImpairmentConfig config);
+
+  // Departures never decrease, so the stream stays in order.
+  std::vector<Segment> schedule(size_t size, Clock::time_point arrival);
+
+  uint64_t getSegments() const { return segments_; }
+  uint64_t getStalls() const { return stalls_; }
+
+private:
+  void startSegment();
+
+  ImpairmentConfig config_;
+  bool fragmenting_;
+  std::mt19937 random_;
+  size_t segmentRemaining_ = 0;
+  std::chrono::microseconds segmentLatency_{0};
+  bool segmentStalls_ = false;
+  Clock::time_point linkFree_;
+  Clock::time_point lastDeparture_;
+  uint64_t segments_ = 0;
+  uint64_t stalls_ = 0;
+};
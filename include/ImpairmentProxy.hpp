@@ -0,0 +1,73 @@
+#pragma once
+
+#include "HandlerAllocator.hpp"
+#include "ImpairmentModel.hpp"
+
+#include <array>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Local TCP proxy that forwards one connection to a target through an
+// ImpairmentModel: bytes from the client reach the target late, cut into
+// segments, rate limited and occasionally stalled. Only the client-to-target
+// direction is forwarded, which is all the video transport uses.
+class ImpairmentProxy {
+public:
+  ImpairmentProxy(uint16_t listenPort, const std::string &targetHost,
+                  uint16_t targetPort, ImpairmentConfig config);
+  ~ImpairmentProxy();
+
+  // Serves on a background thread until the client finishes or stop().
+  void start();
+  void wait();
+  // Thread-safe; drops queued segments and closes both connections.
+  void stop();
+
+  uint16_t getPort() const { return port_; }
+  uint64_t getBytesForwarded() const { return bytesForwarded_; }
+  uint64_t getSegmentsForwarded() const { return segmentsForwarded_; }
+  uint64_t getStalls() const { return stalls_; }
+
+private:
+  struct PendingSegment {
+    std::vector<char> data;
+    ImpairmentModel::Clock::time_point departure;
+  };
+
+  void onAccepted(const boost::system::error_code &error);
+  void readNextData();
+  void onDataRead(const boost::system::error_code &error,
+                  std::size_t bytesRead);
+  void forwardNextSegment();
+  void finish();
+
+  boost::asio::io_context ioContext_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  boost::asio::ip::tcp::socket client_;
+  boost::asio::ip::tcp::socket target_;
+  boost::asio::steady_timer departureTimer_;
+  uint16_t port_;
+  std::string targetHost_;
+  uint16_t targetPort_;
+  ImpairmentModel model_;
+
+  std::array<char, 65536> readBuffer_;
+  HandlerMemory readHandlerMemory_;
+  HandlerMemory writeHandlerMemory_;
+  std::deque<PendingSegment> pending_;
+  size_t pendingBytes_ = 0;
+  size_t bufferBytes_;
+  bool readPaused_ = false;
+  bool forwarding_ = false;
+  bool clientFinished_ = false;
+  std::thread thread_;
+
+  std::atomic<uint64_t> bytesForwarded_{0};
+  std::atomic<uint64_t> segmentsForwarded_{0};
+  std::atomic<uint64_t> stalls_{0};
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "DataFile.hpp"
+#include "FrameIndex.hpp"
+#include "MappedFile.hpp"
+
+// Read-only IDataFile over a memory-mapped recording and its FrameIndex.
+// Framing is validated once up front, and prefault() warms the first frames
+// before the transport clock starts.
+class IndexedDataFile : public IDataFile {
+public:
+  explicit IndexedDataFile(const std::string &filename);
+
+  void writeBinaryData(const std::vector<char> &data) override;
+  std::optional<std::vector<char>> readNextDataUnit() override;
+
+  // Returns the number of bytes covered by the first `frames` frames.
+  size_t prefault(size_t frames);
+
+  size_t getFrameCount() const { return index_.size(); }
+  bool indexWasLoaded() const { return index_.wasLoaded(); }
+
+private:
+  MappedFile file_;
+  FrameIndex index_;
+  size_t nextFrame_ = 0;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "DataAcceptor.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class DataUnitConverter;
+
+struct JitterBufferConfig {
+  std::chrono::microseconds interval{10000};
+  size_t capacity = 64;
+  std::chrono::microseconds initialDelay{20000};
+  std::chrono::microseconds minDelay{0};
+  std::chrono::microseconds maxDelay{200000};
+  // Runs first on the playout thread, e.g. to pin it.
+  std::function<void()> threadInit;
+};
+
+// Holds complete data units in a fixed ring keyed by sequence number and
+// hands them to the inner acceptor on a local playout clock, one interval
+// apart. The target delay follows the measured inter-arrival jitter: it
+// jumps up when a frame would be late and decays slowly otherwise. The
+// inner acceptor is only called from the playout thread; if it throws,
+// playout stops, the held frames are dropped and the next push rethrows the
+// error to the receiving side.
+class JitterBuffer : public IDataAcceptor {
+public:
+  using Clock = std::chrono::steady_clock;
+  static constexpr double JitterMultiplier = 3.0;
+  static constexpr int DecaySteps = 256;
+  static constexpr std::chrono::microseconds SpinThreshold{200};
+
+  struct Stats {
+    size_t framesReleased = 0;
+    size_t lateFrames = 0;
+    size_t underruns = 0;
+    size_t overflows = 0;
+    size_t lostFrames = 0;
+    size_t maxOccupancy = 0;
+    uint64_t occupancySum = 0;
+    size_t occupancySamples = 0;
+    std::chrono::microseconds targetDelay{0};
+    std::chrono::microseconds jitter{0};
+    std::string error; // why playout stopped early, empty otherwise
+
+    double averageOccupancy() const;
+  };
+
+  JitterBuffer(std::unique_ptr<IDataAcceptor> inner,
+               JitterBufferConfig config = {});
+  ~JitterBuffer() override;
+
+  void processRawData(const std::vector<char> &rawData) override;
+  void processRawData(const std::vector<char> &rawData,
+                      std::chrono::system_clock::time_point arrivalTime)
+      override;
+  size_t getDataUnitsReceived() const override;
+  size_t getTotalBytesReceived() const override;
+
+  // Inserts one encoded data unit; sequences may arrive out of order within
+  // the ring capacity. Blocks while the ring is full. Throws once playout
+  // has failed.
+  void push(uint64_t sequence, std::vector<char> frame,
+            Clock::time_point arrival);
+  // Plays out everything still held at its due time, then stops the playout
+  // thread.
+  void drain();
+
+  Stats getStats() const;
+  size_t getOccupancy() const;
+
+private:
+  struct Slot {
+    bool filled = false;
+    uint64_t sequence = 0;
+    std::vector<char> frame;
+  };
+
+  Clock::time_point dueTime(uint64_t sequence) const;
+  std::chrono::microseconds nominalOffset(uint64_t sequence) const;
+  void updateTarget(uint64_t sequence, Clock::time_point arrival);
+  void playout();
+
+  std::unique_ptr<IDataAcceptor> inner_;
+  JitterBufferConfig config_;
+  std::unique_ptr<DataUnitConverter> converter_;
+  size_t totalBytesReceived_ = 0;
+  uint64_t nextSequence_ = 0;
+
+  mutable std::mutex mutex_;
+  std::condition_variable frameArrived_;
+  std::condition_variable spaceAvailable_;
+  std::vector<Slot> ring_;
+  size_t occupancy_ = 0;
+  uint64_t playoutSequence_ = 0;
+  bool started_ = false;
+  // Frame n is due at baseArrival_ + n * interval + target_.
+  Clock::time_point baseArrival_;
+  Clock::time_point lastArrival_;
+  Clock::time_point lastRelease_;
+  std::chrono::duration<double, std::micro> jitter_{0};
+  std::chrono::duration<double, std::micro> target_;
+  uint64_t underrunSequence_ = UINT64_MAX;
+  bool hurry_ = false;
+  bool draining_ = false;
+  bool failed_ = false;
+  Stats stats_;
+  std::thread playoutThread_;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CaptureJournal.hpp"
+#include "DataFile.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Crash-consistent capture output. Data units are buffered instead of
+// flushed one by one; every commitFrames units or commitInterval the file
+// and its timestamp log are synced and a commit record naming both sizes
+// goes to the CaptureJournal. A commit falls due as units complete and is
+// taken before the next unit, or by a background thread once the stream
+// goes quiet and the last unit's timestamp is logged. Space is reserved in
+// preallocateBytes extents ahead of the writes, so the file size stays the
+// data written. After a crash, CaptureJournal::recover cuts both files back
+// to the last commit.
+class JournaledDataFile : public IDataFile {
+public:
+  static constexpr size_t DefaultCommitFrames = 100;
+  static constexpr std::chrono::milliseconds DefaultCommitInterval{200};
+  static constexpr uint64_t DefaultPreallocateBytes = 64 << 20;
+
+  // timestampFileName may be empty when the capture has no log. The log is
+  // opened at the first commit, so it may be created after this file.
+  JournaledDataFile(
+      const std::string &filename, const std::string &timestampFileName,
+      size_t commitFrames = DefaultCommitFrames,
+      std::chrono::milliseconds commitInterval = DefaultCommitInterval,
+      uint64_t preallocateBytes = DefaultPreallocateBytes);
+  ~JournaledDataFile() override;
+
+  void writeBinaryData(const std::vector<char> &data) override;
+  std::optional<std::vector<char>> readNextDataUnit() override;
+  void writePartialData(const char *data, size_t size) override;
+  void finishDataUnit() override;
+
+  // Syncs and commits every complete unit written so far. Thread-safe.
+  void commit();
+  uint64_t getCommitCount() const { return journal_.getCommitCount(); }
+  uint64_t getPreallocatedBytes() const { return preallocatedBytes_; }
+
+private:
+  void commitLocked();
+  void preallocate(uint64_t endOffset);
+  // Size of the timestamp log, 0 while it does not exist yet.
+  uint64_t timestampLogSize();
+  void runCommitter();
+
+  std::string filename_;
+  std::string timestampFileName_;
+  size_t commitFrames_;
+  std::chrono::milliseconds commitInterval_;
+  uint64_t preallocateBytes_;
+  std::fstream file_;
+  int syncFd_ = -1;
+  int timestampFd_ = -1;
+  CaptureJournal journal_;
+
+  uint64_t bytesWritten_ = 0;
+  uint64_t preallocatedBytes_ = 0;
+  uint64_t frames_ = 0;
+  uint64_t finishedBytes_ = 0;
+  uint64_t committedFrames_ = 0;
+  std::chrono::steady_clock::time_point lastCommitAt_;
+  bool commitDue_ = false;
+  // Log size when the last unit completed; its line makes the log grow.
+  uint64_t timestampBytesAtFinish_ = 0;
+
+  // Guards the file and the counters against the committer thread.
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+  std::thread committer_;
+};
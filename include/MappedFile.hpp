@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Starts readahead for [offset, offset + length) and faults the pages in,
+  // so the first reads of that range do not block on I/O.
+  void willNeed(size_t offset, size_t length) const;
+
+private:
+  const char *data_ = nullptr;
+  size_t size_ = 0;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Bounded frame queue between pacing and the socket writer. When the writer
+// falls behind, delta frames are dropped (oldest first, or once they have
+// waited longer than the latency budget) so that the queue never turns into
+// unbounded delay. Keyframes are never dropped.
+class SendQueue {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Entry {
+    std::shared_ptr<std::vector<char>> frame;
+    bool keyframe = false;
+    Clock::time_point deadline;
+  };
+
+  // A capacity or latency budget of zero disables that limit.
+  explicit SendQueue(
+      size_t capacity = 0,
+      std::chrono::milliseconds maxLatency = std::chrono::milliseconds(0));
+
+  // Returns false when the incoming frame itself was dropped.
+  bool push(std::shared_ptr<std::vector<char>> frame, bool keyframe,
+            Clock::time_point now = Clock::now());
+  std::optional<Entry> pop(Clock::time_point now = Clock::now());
+  void clear();
+
+  bool empty() const;
+  size_t size() const;
+  uint64_t getDroppedFrames() const;
+  uint64_t getDroppedBytes() const;
+
+private:
+  void drop(const Entry &entry);
+
+  size_t capacity_;
+  std::chrono::milliseconds maxLatency_;
+  std::deque<Entry> entries_;
+  uint64_t droppedFrames_ = 0;
+  uint64_t droppedBytes_ = 0;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Single-producer/single-consumer ring of fixed-size frame slots in a named
+// POSIX shared-memory segment. Slots carry 64-bit sequence numbers and the
+// read/write positions live in the segment itself, so either side can be
+// restarted and resume where its predecessor stopped.
+class SharedMemoryRing {
+public:
+  enum class Role { Producer, Consumer };
+
+  static constexpr uint32_t DefaultSlotCount = 64;
+
+  SharedMemoryRing(const std::string &name, Role role,
+                   uint32_t slotCount = DefaultSlotCount);
+  ~SharedMemoryRing();
+
+  SharedMemoryRing(const SharedMemoryRing &) = delete;
+  SharedMemoryRing &operator=(const SharedMemoryRing &) = delete;
+
+  // Blocks while the ring is full.
+  void publish(const char *data, size_t size);
+  // Marks the end of the stream, seen by the consumer after draining.
+  void finish();
+  // Blocks until a frame is available; std::nullopt at end of stream.
+  std::optional<std::vector<char>> consume();
+
+  uint64_t getWriteSequence() const;
+  uint64_t getReadSequence() const;
+  uint32_t getSlotCount() const;
+
+  static void unlink(const std::string &name);
+
+private:
+  struct Header;
+  struct Slot;
+
+  Slot &slot(uint64_t sequence) const;
+
+  std::string name_;
+  Role role_;
+  int fd_ = -1;
+  size_t mappedSize_ = 0;
+  void *mapping_ = nullptr;
+  Header *header_ = nullptr;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+class IDataAcceptor;
+class SharedMemoryRing;
+
+// Same-host alternative to AsioReceiver that consumes data units from a
+// shared-memory ring written by ShmSender.
+class ShmReceiver {
+public:
+  ShmReceiver(const std::string &segmentName,
+              std::unique_ptr<IDataAcceptor> dataAcceptor);
+  ~ShmReceiver();
+
+  void start();
+  size_t getDataUnitsReceived() const;
+  size_t getTotalBytesReceived() const;
+
+private:
+  std::string segmentName_;
+  std::unique_ptr<SharedMemoryRing> ring_;
+  std::unique_ptr<IDataAcceptor> dataAcceptor_;
+};
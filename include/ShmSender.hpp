@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+class IDataProvider;
+class SharedMemoryRing;
+
+// Same-host alternative to AsioSender that publishes data units into a
+// shared-memory ring instead of a TCP socket.
+class ShmSender {
+public:
+  ShmSender(const std::string &segmentName,
+            std::unique_ptr<IDataProvider> dataProvider);
+  ~ShmSender();
+
+  void startTransport(
+      std::chrono::microseconds delay = std::chrono::milliseconds(10));
+
+private:
+  std::unique_ptr<IDataProvider> dataProvider_;
+  std::unique_ptr<SharedMemoryRing> ring_;
+};
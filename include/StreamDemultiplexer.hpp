@@ -0,0 +1,44 @@
+#pragma once
+
+#include "DataAcceptor.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+class DataUnitConverter;
+
+// Splits a multiplexed connection (2-byte stream ID + data unit per frame)
+// into per-stream acceptors, created on the first frame of each stream.
+class StreamDemultiplexer : public IDataAcceptor {
+public:
+  using AcceptorFactory =
+      std::function<std::unique_ptr<IDataAcceptor>(uint16_t streamId)>;
+
+  explicit StreamDemultiplexer(AcceptorFactory acceptorFactory);
+  ~StreamDemultiplexer() override;
+
+  void processRawData(const std::vector<char> &rawData) override;
+  void processRawData(const std::vector<char> &rawData,
+                      std::chrono::system_clock::time_point arrivalTime)
+      override;
+  size_t getDataUnitsReceived() const override;
+  size_t getTotalBytesReceived() const override;
+
+  size_t getStreamCount() const;
+  const IDataAcceptor *getStream(uint16_t streamId) const;
+
+private:
+  void demultiplex(
+      const std::vector<char> &rawData,
+      std::optional<std::chrono::system_clock::time_point> arrivalTime);
+  IDataAcceptor &streamAcceptor(uint16_t streamId);
+
+  AcceptorFactory acceptorFactory_;
+  std::unique_ptr<DataUnitConverter> converter_;
+  std::map<uint16_t, std::unique_ptr<IDataAcceptor>> streams_;
+  std::vector<char> buffer_;
+  size_t totalBytesReceived_ = 0;
+};
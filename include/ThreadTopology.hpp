@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Which CPUs each pipeline stage runs on and which NUMA node its memory
+// comes from. Applied best-effort like TuningProfile: what the platform or
+// the process privileges do not allow is reported and skipped.
+struct ThreadTopology {
+  enum class Role { Io, Workers, Playout };
+
+  struct Placement {
+    std::vector<int> cpus; // empty leaves the thread floating
+    int numaNode = -1;     // -1 keeps the default allocation policy
+
+    bool empty() const { return cpus.empty() && numaNode < 0; }
+    std::string describe() const;
+  };
+
+  // CPU affinity and memory policy of a thread.
+  struct ThreadState {
+    std::vector<int> cpus; // empty when unknown
+    int memoryPolicy = 0;  // MPOL_DEFAULT
+    unsigned long nodeMask = 0;
+  };
+
+  Placement io;      // socket I/O; decode, write and timestamps without a
+                     // jitter buffer
+  Placement workers; // sender compression pool
+  Placement playout; // receiver jitter buffer: decode, write and timestamps
+  // State of the thread that parsed the topology, before io was applied to
+  // it. Threads it spawns later inherit the io placement, so stages without
+  // a placement of their own are put back to this.
+  ThreadState inherited;
+
+  // "io:0/workers:2-5,8/playout:node1"; a node name selects all its CPUs.
+  static ThreadTopology parse(const std::string &spec);
+  static std::vector<int> parseCpuList(const std::string &list);
+
+  static int nodeCount();
+  static std::vector<int> cpusOfNode(int node);
+  static int nodeOfCpu(int cpu);
+
+  const Placement &placement(Role role) const;
+  static ThreadState currentThreadState();
+
+  // Pins the calling thread and makes its allocations prefer the node, so
+  // the frame buffers a stage allocates are local to it.
+  void apply(Role role) const;
+  std::string describe() const;
+
+  // Measures frame-sized copies for every memory node / CPU node pair and
+  // the hand-off latency between the configured stages.
+  void runBenchmark(std::ostream &out,
+                    size_t bytes = 64 * 1024 * 1024) const;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <fstream>
 #include <string>
 
@@ -9,6 +10,8 @@ class ITimestampWriter {
 public:
   virtual ~ITimestampWriter() = default;
   virtual void write(const DataUnit &dataUnit) = 0;
+  virtual void write(const DataUnit &dataUnit,
+                     std::chrono::system_clock::time_point timestamp) = 0;
   virtual void open(const std::string &filename) = 0;
   virtual void close() = 0;
 };
@@ -23,6 +26,8 @@ public:
   ~TimestampWriter();
 
   void write(const DataUnit &dataUnit) override;
+  void write(const DataUnit &dataUnit,
+             std::chrono::system_clock::time_point timestamp) override;
   void open(const std::string &filename) override;
   void close() override;
 };
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Hot-path tracing. Each thread records into its own fixed-size ring that
+// only it writes, so a trace point costs two clock reads and a few relaxed
+// stores. The VT_TRACE_* macros compile to nothing unless the build enables
+// VIDEO_TRANSPORT_TRACING; the classes stay available for the exporter.
+class TraceBuffer {
+public:
+  static constexpr size_t Capacity = 1 << 14; // events per thread
+
+  struct Event {
+    const char *name;
+    uint64_t startNs;
+    uint64_t durationNs;
+    char phase; // Chrome trace phase: 'X' complete, 'B' begin, 'E' end
+  };
+
+  TraceBuffer(uint32_t threadId, std::string threadName);
+
+  void record(const char *name, uint64_t startNs, uint64_t durationNs,
+              char phase);
+  // Copies the retained events, oldest first. Safe while the owner records;
+  // slots overwritten during the copy are left out, as is the oldest slot of
+  // a full buffer, which the owner may be writing.
+  std::vector<Event> snapshot() const;
+
+  uint32_t getThreadId() const { return threadId_; }
+  const std::string &getThreadName() const { return threadName_; }
+  void setThreadName(std::string name) { threadName_ = std::move(name); }
+
+private:
+  struct Slot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint64_t> startNs{0};
+    std::atomic<uint64_t> durationNs{0};
+    std::atomic<char> phase{'X'};
+  };
+
+  uint32_t threadId_;
+  std::string threadName_;
+  std::atomic<uint64_t> head_{0};
+  std::array<Slot, Capacity> slots_;
+};
+
+class Tracer {
+public:
+#ifdef VT_TRACING_ENABLED
+  static constexpr bool Enabled = true;
+#else
+  static constexpr bool Enabled = false;
+#endif
+
+  static Tracer &instance();
+  static uint64_t nowNs();
+
+  // Names the calling thread in exported traces; call before its first event.
+  void setThreadName(const std::string &name);
+  void record(const char *name, uint64_t startNs, uint64_t durationNs,
+              char phase = 'X');
+
+  // Chrome trace-event JSON, loadable in chrome://tracing and Perfetto.
+  void writeChromeTrace(std::ostream &out) const;
+  bool writeChromeTrace(const std::string &filename) const;
+  // Writes a snapshot to `filename` whenever the process receives `signal`.
+  // Must run before any other thread is started so they inherit the mask.
+  void dumpOnSignal(int signal, const std::string &filename);
+
+private:
+  Tracer() = default;
+  TraceBuffer &threadBuffer();
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<TraceBuffer>> buffers_;
+};
+
+class TraceScope {
+public:
+  explicit TraceScope(const char *name)
+      : name_(name), startNs_(Tracer::nowNs()) {}
+  ~TraceScope() {
+    Tracer::instance().record(name_, startNs_, Tracer::nowNs() - startNs_);
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  const char *name_;
+  uint64_t startNs_;
+};
+
+#ifdef VT_TRACING_ENABLED
+#define VT_TRACE_CONCAT_INNER(a, b) a##b
+#define VT_TRACE_CONCAT(a, b) VT_TRACE_CONCAT_INNER(a, b)
+#define VT_TRACE_SCOPE(name)                                                   \
+  TraceScope VT_TRACE_CONCAT(traceScope, __LINE__)(name)
+// Begin/end pairs for spans that cross an asynchronous wait on one thread.
+#define VT_TRACE_BEGIN(name)                                                   \
+  Tracer::instance().record(name, Tracer::nowNs(), 0, 'B')
+#define VT_TRACE_END(name)                                                     \
+  Tracer::instance().record(name, Tracer::nowNs(), 0, 'E')
+#else
+#define VT_TRACE_SCOPE(name) ((void)0)
+#define VT_TRACE_BEGIN(name) ((void)0)
+#define VT_TRACE_END(name) ((void)0)
+#endif
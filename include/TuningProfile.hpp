@@ -0,0 +1,25 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <string>
+
+// Kernel socket and I/O thread settings applied by AsioSender and
+// AsioReceiver. Every setting is best-effort: options the platform or the
+// process privileges do not allow are reported and skipped.
+struct TuningProfile {
+  std::string name = "default";
+  int sendBufferBytes = 0;    // SO_SNDBUF, 0 keeps the kernel default
+  int receiveBufferBytes = 0; // SO_RCVBUF, 0 keeps the kernel default
+  int busyPollMicros = 0;     // SO_BUSY_POLL, 0 disables busy polling
+  bool quickAck = false;      // TCP_QUICKACK, re-armed after every read
+  bool zeroCopy = false;      // SO_ZEROCOPY + MSG_ZEROCOPY on send
+  bool kernelTimestamps = false; // SO_TIMESTAMPING RX/TX software stamps
+  int cpuAffinity = -1;          // pin the I/O thread, -1 leaves it floating
+  int fifoPriority = 0;          // SCHED_FIFO priority, 0 keeps SCHED_OTHER
+
+  static TuningProfile fromName(const std::string &name);
+
+  void applySocketOptions(boost::asio::ip::tcp::socket &socket) const;
+  void applyThreadOptions() const;
+  void rearmQuickAck(boost::asio::ip::tcp::socket &socket) const;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of threads running submitted tasks in FIFO order.
+class WorkerPool {
+public:
+  // threadInit runs first on every worker thread, e.g. to pin it.
+  explicit WorkerPool(unsigned threads = 0,
+                      std::function<void()> threadInit = {});
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  template <typename Task>
+  auto submit(Task task) -> std::future<decltype(task())> {
+    auto packaged =
+        std::make_shared<std::packaged_task<decltype(task())()>>(
+            std::move(task));
+    auto result = packaged->get_future();
+    enqueue([packaged]() { (*packaged)(); });
+    return result;
+  }
+
+  size_t getThreadCount() const { return threads_.size(); }
+
+private:
+  void enqueue(std::function<void()> task);
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  bool stopping_ = false;
+};
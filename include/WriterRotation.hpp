@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+class IDataFile;
+class ITimestampWriter;
+
+// Hands a new output file and timestamp log from a control thread to the
+// thread writing data units, which swaps them in between two units. The
+// writing thread only takes the lock when a rotation is pending.
+class WriterRotation {
+public:
+  WriterRotation();
+  ~WriterRotation();
+
+  // Thread-safe; a second request before the swap replaces the first.
+  void request(std::unique_ptr<IDataFile> videoDataWriter,
+               std::unique_ptr<ITimestampWriter> timestampWriter);
+  // Called by the writing thread between units; moves pending writers into
+  // the given ones and closes the old ones.
+  void apply(std::unique_ptr<IDataFile> &videoDataWriter,
+             std::unique_ptr<ITimestampWriter> &timestampWriter);
+
+private:
+  std::mutex mutex_;
+  std::atomic<bool> pending_{false};
+  std::unique_ptr<IDataFile> nextVideoDataWriter_;
+  std::unique_ptr<ITimestampWriter> nextTimestampWriter_;
+};
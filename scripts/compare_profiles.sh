@@ -0,0 +1,115 @@
+#!/bin/bash
+
+# Video Transport - Tuning Profile Comparison
+# Runs the sender and receiver over loopback once per tuning profile and
+# prints inter-arrival and TX->RX latency statistics side by side.
+# Expects an existing build in build/ (see clean_build_test.sh).
+
+set -e
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+print_status() {
+    echo -e "${BLUE}[INFO]${NC} $1"
+}
+
+print_success() {
+    echo -e "${GREEN}[SUCCESS]${NC} $1"
+}
+
+print_error() {
+    echo -e "${RED}[ERROR]${NC} $1"
+}
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+
+if [ "$1" = "-h" ] || [ "$1" = "--help" ]; then
+    echo "Usage: $0 [INPUT_FILE] [PROFILE...]"
+    echo ""
+    echo "  INPUT_FILE: Path to binary file to send (default: resources/front_0.bin)"
+    echo "  PROFILE:    Tuning profiles to compare (default: default latency throughput)"
+    echo ""
+    echo "  IMPAIR=\"<vt-impair options>\" routes every run through build/bin/vt-impair,"
+    echo "  e.g. IMPAIR=\"--delay-us=2000 --jitter-us=500 --segment=1-1460 --seed=1\""
+    exit 0
+fi
+
+INPUT_FILE=${1:-"resources/front_0.bin"}
+shift || true
+PROFILES=${@:-"default latency throughput"}
+RECEIVER_PORT=8081
+PROXY_PORT=8082
+OUTPUT_DIR="output/profiles"
+
+cd "$PROJECT_ROOT"
+
+if [ ! -x build/bin/sender ] || [ ! -x build/bin/receiver ]; then
+    print_error "Binaries not found in build/bin, run ./scripts/clean_build_test.sh first"
+    exit 1
+fi
+
+if [ -n "$IMPAIR" ] && [ ! -x build/bin/vt-impair ]; then
+    print_error "IMPAIR is set but build/bin/vt-impair was not found"
+    exit 1
+fi
+
+mkdir -p "$OUTPUT_DIR"
+
+# Prints "<count> <mean_ms> <max_ms>" for the deltas between the timestamps
+# of two files (or consecutive lines of one file when both are the same).
+timestamp_stats() {
+    paste -d'|' "$1" "$2" | awk -F'|' -v pairwise="$3" '
+        function seconds(line,    t) {
+            split(substr(line, 12, 15), t, ":")
+            return t[1] * 3600 + t[2] * 60 + t[3]
+        }
+        {
+            a = seconds($1); b = seconds($2)
+            if (pairwise == "1") { d = (b - a) * 1000 }
+            else if (NR > 1) { d = (a - prev) * 1000 } else { prev = a; next }
+            prev = a; n++; sum += d; if (d > max) max = d
+        }
+        END { if (n > 0) printf "%d %.3f %.3f", n, sum / n, max; else printf "0 - -" }'
+}
+
+printf "%-12s %8s %14s %14s %14s %14s\n" "profile" "intervals" "interval_avg" "interval_max" "latency_avg" "latency_max"
+for profile in $PROFILES; do
+    OUTPUT_FILE="$OUTPUT_DIR/received_$profile.bin"
+    TX_FILE="$OUTPUT_DIR/tx_$profile.txt"
+    rm -f "$OUTPUT_FILE" "$OUTPUT_FILE"_timestamps.txt "$TX_FILE"
+
+    ./build/bin/receiver "$OUTPUT_FILE" "$RECEIVER_PORT" --profile="$profile" > "$OUTPUT_DIR/receiver_$profile.log" 2>&1 &
+    RECEIVER_PID=$!
+    sleep 1
+    SENDER_PORT=$RECEIVER_PORT
+    if [ -n "$IMPAIR" ]; then
+        # shellcheck disable=SC2086
+        ./build/bin/vt-impair "$PROXY_PORT" localhost "$RECEIVER_PORT" $IMPAIR > "$OUTPUT_DIR/impair_$profile.log" 2>&1 &
+        IMPAIR_PID=$!
+        SENDER_PORT=$PROXY_PORT
+        sleep 1
+    fi
+    ./build/bin/sender "$INPUT_FILE" localhost "$SENDER_PORT" --profile="$profile" \
+        --tx-timestamps="$TX_FILE" > "$OUTPUT_DIR/sender_$profile.log" 2>&1
+    if [ -n "$IMPAIR" ]; then
+        wait $IMPAIR_PID || true
+    fi
+    wait $RECEIVER_PID || true
+
+    if ! cmp -s "$INPUT_FILE" "$OUTPUT_FILE"; then
+        print_error "Profile $profile: received data differs from input"
+        exit 1
+    fi
+
+    RX_FILE="$OUTPUT_FILE"_timestamps.txt
+    read -r intervals interval_avg interval_max <<< "$(timestamp_stats "$RX_FILE" "$RX_FILE" 0)"
+    read -r _ latency_avg latency_max <<< "$(timestamp_stats "$TX_FILE" "$RX_FILE" 1)"
+    printf "%-12s %8s %14s %14s %14s %14s\n" "$profile" "$intervals" "$interval_avg" "$interval_max" "$latency_avg" "$latency_max"
+done
+
+print_success "Profile comparison completed (times in ms, logs in $OUTPUT_DIR)"
@@ -5,8 +5,8 @@
 # 1. Build and run unit tests
 # 2. Start receiver
 # 3. Start sender
-# 4. Check data integrity
-# 5. Analyze timestamp differences
+# 4. Check data integrity (vt-analyze, frame by frame)
+# 5. Analyze timestamp differences (vt-analyze)
 
 set -e  # Exit on any error
 
@@ -99,7 +99,7 @@ cleanup_at_start() {
     pkill -f "sender.*localhost.*$RECEIVER_PORT" 2>/dev/null || true
     
     # Clean up test files and create output directory
-    rm -f "$OUTPUT_FILE" "$OUTPUT_FILE"_timestamps.txt "$RECEIVER_LOG" "$SENDER_LOG" 2>/dev/null || true
+    rm -f "$OUTPUT_FILE" "$OUTPUT_FILE"_timestamps.txt "$RECEIVER_LOG" "$SENDER_LOG" output/analysis.txt 2>/dev/null || true
     mkdir -p "$(dirname "$OUTPUT_FILE")" 2>/dev/null || true
     
     print_success "Cleanup completed"
@@ -193,25 +193,16 @@ if [ ! -f "$INPUT_FILE" ]; then
     exit 1
 fi
 
-# Compare file sizes
-INPUT_SIZE=$(wc -c < "$INPUT_FILE")
-OUTPUT_SIZE=$(wc -c < "$OUTPUT_FILE")
-
-print_status "Input file size: $INPUT_SIZE bytes"
-print_status "Output file size: $OUTPUT_SIZE bytes"
-
-if [ "$INPUT_SIZE" -eq "$OUTPUT_SIZE" ]; then
-    print_success "File sizes match"
-else
-    print_error "File sizes don't match!"
-    exit 1
-fi
+TIMESTAMP_FILE="$OUTPUT_FILE"_timestamps.txt
+ANALYSIS_FILE="output/analysis.txt"
 
-# Binary comparison
-if diff "$INPUT_FILE" "$OUTPUT_FILE" >/dev/null; then
-    print_success "Data integrity verified - files are identical!"
+# Frame-by-frame comparison against the source (reports the first divergence)
+# plus timing analysis of the timestamp log, in one pass
+if ./build/bin/vt-analyze "$OUTPUT_FILE" --source="$INPUT_FILE" --timestamps="$TIMESTAMP_FILE" > "$ANALYSIS_FILE" 2>&1; then
+    print_success "Data integrity verified - all frames identical!"
 else
-    print_error "Data integrity check failed - files differ!"
+    cat "$ANALYSIS_FILE"
+    print_error "Data integrity check failed!"
     exit 1
 fi
 echo
@@ -219,70 +210,14 @@ echo
 # Step 7: Analyze timestamp differences
 print_step "Step 7: Analyzing timestamp differences"
 echo "==========================================="
-TIMESTAMP_FILE="$OUTPUT_FILE"_timestamps.txt
-
 if [ ! -f "$TIMESTAMP_FILE" ]; then
     print_error "Timestamp file not found: $TIMESTAMP_FILE"
     exit 1
 fi
 
-# Count data units
-DATA_UNITS=$(wc -l < "$TIMESTAMP_FILE")
-print_status "Total data units received: $DATA_UNITS"
-
-# Run timestamp analysis
-if command -v python3 >/dev/null 2>&1; then
-    if [ -f "scripts/analyze_timestamps.py" ]; then
-        print_status "Running timestamp analysis..."
-        echo "----------------------------------------"
-        python3 scripts/analyze_timestamps.py "$TIMESTAMP_FILE"
-        echo "----------------------------------------"
-    else
-        print_warning "scripts/analyze_timestamps.py not found, skipping detailed analysis"
-    fi
-else
-    print_warning "Python3 not available, skipping timestamp analysis"
-fi
-
-# Also print a simple summary of timestamp differences
-print_status "Timestamp differences summary:"
-if [ -f "$TIMESTAMP_FILE" ]; then
-    # Extract timestamps and calculate differences
-    echo "----------------------------------------"
-    echo "Timestamp differences (in milliseconds):"
-    echo "----------------------------------------"
-    
-    # Read timestamps and calculate differences
-    prev_timestamp=""
-    line_num=0
-    
-    while IFS= read -r line; do
-        # Extract timestamp from line like: "2025-08-04 22:21:30.783 - Video Unit: 6 bytes (length: 2)"
-        timestamp=$(echo "$line" | grep -o '^[0-9]\{4\}-[0-9]\{2\}-[0-9]\{2\} [0-9]\{2\}:[0-9]\{2\}:[0-9]\{2\}\.[0-9]\{3\}' | head -1)
-        
-        if [ ! -z "$timestamp" ]; then
-            line_num=$((line_num + 1))
-            
-            if [ ! -z "$prev_timestamp" ]; then
-                # Calculate difference using date command
-                diff_ms=$(python3 -c "
-import datetime
-t1 = datetime.datetime.strptime('$prev_timestamp', '%Y-%m-%d %H:%M:%S.%f')
-t2 = datetime.datetime.strptime('$timestamp', '%Y-%m-%d %H:%M:%S.%f')
-diff = (t2 - t1).total_seconds() * 1000
-print(f'{diff:.1f}')
-" 2>/dev/null || echo "N/A")
-                
-                echo "Between $((line_num-1)) and $line_num: ${diff_ms} ms"
-            fi
-            prev_timestamp="$timestamp"
-        fi
-    done < "$TIMESTAMP_FILE"
-    
-    echo "----------------------------------------"
-else
-    print_warning "Timestamp file not found for manual analysis"
-fi
+echo "----------------------------------------"
+cat "$ANALYSIS_FILE"
+echo "----------------------------------------"
 echo
 
 # Step 8: Display receiver statistics
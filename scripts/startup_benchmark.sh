@@ -0,0 +1,102 @@
+#!/bin/bash
+
+# Video Transport - Startup Benchmark
+# Measures time-to-first-frame over loopback with and without the sender's
+# warm-start phase (frame index, prefault, prefetched buffers).
+# Expects an existing build in build/ (see clean_build_test.sh).
+
+set -e
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+BLUE='\033[0;34m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+print_status() {
+    echo -e "${BLUE}[INFO]${NC} $1"
+}
+
+print_success() {
+    echo -e "${GREEN}[SUCCESS]${NC} $1"
+}
+
+print_warning() {
+    echo -e "${YELLOW}[WARNING]${NC} $1"
+}
+
+print_error() {
+    echo -e "${RED}[ERROR]${NC} $1"
+}
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+
+if [ "$1" = "-h" ] || [ "$1" = "--help" ]; then
+    echo "Usage: $0 [INPUT_FILE] [RUNS] [WARM_FRAMES]"
+    echo ""
+    echo "  INPUT_FILE:  Path to binary file to send (default: resources/front_0.bin)"
+    echo "  RUNS:        Runs per mode (default: 5)"
+    echo "  WARM_FRAMES: Frames warmed in warm mode (default: 32)"
+    echo ""
+    echo "Page cache is dropped before every run when /proc/sys/vm/drop_caches is writable."
+    exit 0
+fi
+
+INPUT_FILE=${1:-"resources/front_0.bin"}
+RUNS=${2:-5}
+WARM_FRAMES=${3:-32}
+RECEIVER_PORT=8082
+OUTPUT_DIR="output/startup"
+
+cd "$PROJECT_ROOT"
+
+if [ ! -x build/bin/sender ] || [ ! -x build/bin/receiver ]; then
+    print_error "Binaries not found in build/bin, run ./scripts/clean_build_test.sh first"
+    exit 1
+fi
+
+mkdir -p "$OUTPUT_DIR"
+
+DROP_CACHES=0
+if [ -w /proc/sys/vm/drop_caches ]; then
+    DROP_CACHES=1
+else
+    print_warning "Cannot drop the page cache, runs after the first start warm"
+fi
+
+# Prints "<min> <median> <max>" of the numbers on stdin.
+summary() {
+    sort -n | awk '{ v[NR] = $1 } END { printf "%d %d %d", v[1], v[int((NR + 1) / 2)], v[NR] }'
+}
+
+printf "%-6s %6s %26s %26s\n" "mode" "runs" "from_clock_us min/med/max" "from_launch_us min/med/max"
+for mode in cold warm; do
+    FLAGS="--warm-frames=0"
+    if [ "$mode" = "warm" ]; then
+        FLAGS="--warm-frames=$WARM_FRAMES"
+    fi
+    : > "$OUTPUT_DIR/$mode.txt"
+
+    for run in $(seq 1 "$RUNS"); do
+        if [ "$DROP_CACHES" = "1" ]; then
+            sync
+            echo 1 > /proc/sys/vm/drop_caches
+        fi
+        ./build/bin/receiver "$OUTPUT_DIR/received.bin" "$RECEIVER_PORT" > "$OUTPUT_DIR/receiver.log" 2>&1 &
+        RECEIVER_PID=$!
+        sleep 0.5
+        ./build/bin/sender "$INPUT_FILE" localhost "$RECEIVER_PORT" $FLAGS > "$OUTPUT_DIR/sender_$mode.log" 2>&1
+        wait $RECEIVER_PID || true
+
+        # "Time to first frame: <clock> us after transport start (<launch> us after launch)"
+        awk '/^Time to first frame:/ { print $5, $10 }' "$OUTPUT_DIR/sender_$mode.log" | tr -d '(' >> "$OUTPUT_DIR/$mode.txt"
+    done
+
+    read -r clock_min clock_med clock_max <<< "$(cut -d' ' -f1 "$OUTPUT_DIR/$mode.txt" | summary)"
+    read -r launch_min launch_med launch_max <<< "$(cut -d' ' -f2 "$OUTPUT_DIR/$mode.txt" | summary)"
+    printf "%-6s %6s %26s %26s\n" "$mode" "$RUNS" "$clock_min/$clock_med/$clock_max" "$launch_min/$launch_med/$launch_max"
+done
+
+print_success "Startup benchmark completed (logs in $OUTPUT_DIR)"
@@ -0,0 +1,164 @@
+#include <iostream>
+#include "CaptureAnalyzer.hpp"
+#include "MappedFile.hpp"
+
+#include <filesystem>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+std::string formatPercentiles(const std::vector<double> &values) {
+  static const char *labels[] = {"min", "p50", "p90", "p99", "p99.9", "max"};
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < values.size(); ++i) {
+    ss << (i == 0 ? "" : "  ") << labels[i] << " " << values[i];
+  }
+  return ss.str();
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> positional;
+  std::string sourceFile;
+  std::string timestampFile;
+  long intervalUs = 10000;
+  long windowMs = 1000;
+  unsigned threads = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--source=", 0) == 0) {
+      sourceFile = arg.substr(std::string("--source=").size());
+    } else if (arg.rfind("--timestamps=", 0) == 0) {
+      timestampFile = arg.substr(std::string("--timestamps=").size());
+    } else if (arg.rfind("--interval-us=", 0) == 0) {
+      intervalUs = std::stol(arg.substr(std::string("--interval-us=").size()));
+    } else if (arg.rfind("--window-ms=", 0) == 0) {
+      windowMs = std::stol(arg.substr(std::string("--window-ms=").size()));
+    } else if (arg.rfind("--threads=", 0) == 0) {
+      threads = static_cast<unsigned>(
+          std::stoul(arg.substr(std::string("--threads=").size())));
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  if (positional.size() != 1 || intervalUs <= 0 || windowMs <= 0) {
+    std::cerr << "Usage: " + std::string(argv[0]) +
+                     " <capture_file> [--source=<file>]"
+                     " [--timestamps=<file>] [--interval-us=<n>]"
+                     " [--window-ms=<n>] [--threads=<n>]"
+              << std::endl;
+    std::cerr << "Example: " + std::string(argv[0]) +
+                     " output/received_data.bin"
+                     " --source=resources/front_0.bin"
+              << std::endl;
+    return 1;
+  }
+
+  std::string captureFile = positional[0];
+  if (timestampFile.empty() &&
+      std::filesystem::exists(captureFile + "_timestamps.txt")) {
+    timestampFile = captureFile + "_timestamps.txt";
+  }
+
+  bool failed = false;
+  try {
+    CaptureAnalyzer analyzer(threads);
+
+    MappedFile capture(captureFile);
+    auto framing = analyzer.indexFrames(capture.data(), capture.size());
+    std::cout << "=== CAPTURE ===" << std::endl;
+    std::cout << "File: " << captureFile << " (" << capture.size()
+              << " bytes)" << std::endl;
+    std::cout << "Frames: " << framing.frames.size() << std::endl;
+    if (framing.error.empty()) {
+      std::cout << "Framing: OK" << std::endl;
+    } else {
+      std::cout << "Framing: ERROR - " << framing.error << " (valid prefix "
+                << framing.validBytes << " bytes)" << std::endl;
+      failed = true;
+    }
+    std::cout << "Digest: 0x" << std::hex << std::setw(16) << std::setfill('0')
+              << analyzer.checksum(capture.data(), framing) << std::dec
+              << std::setfill(' ') << std::endl;
+
+    if (!sourceFile.empty()) {
+      MappedFile source(sourceFile);
+      auto sourceFraming = analyzer.indexFrames(source.data(), source.size());
+      auto divergence = analyzer.compareFrames(capture.data(), framing,
+                                               source.data(), sourceFraming);
+      std::cout << "\n=== SOURCE COMPARISON ===" << std::endl;
+      std::cout << "Source: " << sourceFile << " ("
+                << sourceFraming.frames.size() << " frames)" << std::endl;
+      if (divergence.identical && framing.error.empty() &&
+          sourceFraming.error.empty()) {
+        std::cout << "Result: identical" << std::endl;
+      } else if (divergence.identical) {
+        std::cout << "Result: all complete frames match, but framing is "
+                     "incomplete"
+                  << std::endl;
+        failed = true;
+      } else {
+        std::cout << "Result: first divergence at frame "
+                  << divergence.frameIndex << " (capture offset "
+                  << divergence.captureOffset << "): " << divergence.reason
+                  << std::endl;
+        failed = true;
+      }
+    }
+
+    if (!timestampFile.empty()) {
+      MappedFile log(timestampFile);
+      auto records = analyzer.parseTimestampLog(log.data(), log.size());
+      auto report = analyzer.analyzeTiming(
+          records, std::chrono::microseconds(intervalUs),
+          std::chrono::milliseconds(windowMs));
+
+      std::cout << "\n=== TIMING ===" << std::endl;
+      std::cout << std::fixed << std::setprecision(3);
+      std::cout << "Log: " << timestampFile << std::endl;
+      std::cout << "Units: " << report.units << ", bytes: "
+                << report.totalBytes << ", duration: " << report.durationMs
+                << " ms" << std::endl;
+      if (report.units != framing.frames.size()) {
+        std::cout << "Warning: log has " << report.units
+                  << " units, capture has " << framing.frames.size()
+                  << std::endl;
+      }
+      if (report.outOfOrder > 0) {
+        std::cout << "Warning: " << report.outOfOrder
+                  << " units stamped earlier than a previous one, left out "
+                     "of the timing statistics"
+                  << std::endl;
+      }
+      if (report.units - report.outOfOrder >= 2) {
+        double nominalMs = static_cast<double>(intervalUs) / 1000.0;
+        std::cout << "Interval (ms): " << formatPercentiles(report.intervalMs)
+                  << std::endl;
+        std::cout << "Jitter vs " << nominalMs
+                  << " ms (ms): " << formatPercentiles(report.jitterMs)
+                  << std::endl;
+        std::cout << "Gaps > " << 2 * nominalMs << " ms: " << report.gapCount;
+        if (report.gapCount > 0) {
+          std::cout << " (longest " << report.longestGapMs
+                    << " ms before unit " << report.longestGapUnit << ")";
+        }
+        std::cout << std::endl;
+        std::cout << "Throughput over " << report.windowCount << " x "
+                  << windowMs << " ms windows (MB/s): min "
+                  << report.minWindowMBps << "  mean "
+                  << report.meanWindowMBps << "  max "
+                  << report.maxWindowMBps << std::endl;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+
+  return failed ? 2 : 0;
+}
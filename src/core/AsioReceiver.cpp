@@ -1,61 +1,189 @@
 #include "AsioReceiver.hpp"
 #include "DataAcceptor.hpp"
 #include "Constants.hpp"
+#include "HandlerAllocator.hpp"
+#include "Trace.hpp"
 #include <iostream>
 #include <chrono>
 #include <array>
 
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <linux/errqueue.h>
+#include <sys/socket.h>
+#endif
+
 using boost::asio::ip::tcp;
 
 AsioReceiver::AsioReceiver(uint16_t port,
-                           std::unique_ptr<IDataAcceptor> dataAcceptor)
+                           std::unique_ptr<IDataAcceptor> dataAcceptor,
+                           TuningProfile profile)
     : acceptor_(ioContext_, tcp::endpoint(tcp::v4(), port)),
-      socket_(ioContext_), dataAcceptor_(std::move(dataAcceptor)) {
-  std::cout << "Receiver server listening on 0.0.0.0:" + std::to_string(port)
+      socket_(ioContext_), dataAcceptor_(std::move(dataAcceptor)),
+      profile_(std::move(profile)) {
+  receivedData_.reserve(Constants::MaxPacketSize);
+  if (profile_.receiveBufferBytes > 0) {
+    // Must be set before accept() so the window scale is negotiated for it.
+    acceptor_.set_option(boost::asio::socket_base::receive_buffer_size(
+        profile_.receiveBufferBytes));
+  }
+  std::cout << "Receiver server listening on 0.0.0.0:" +
+                   std::to_string(getPort())
             << std::endl;
 }
 
 void AsioReceiver::start() {
-  acceptor_.accept(socket_);
-  socket_.set_option(boost::asio::ip::tcp::no_delay(true));
-  std::function<void()> processNextData;
-  processNextData = [this, &processNextData]() {
-    try {
-      auto tempBuffer =
-          std::make_shared<std::array<char, Constants::MaxPacketSize>>();
-      socket_.async_read_some(
-          boost::asio::buffer(*tempBuffer),
-          [this, &processNextData, tempBuffer](
-              const boost::system::error_code &error, std::size_t bytesRead) {
-            try {
-              if (!error && bytesRead > 0) {
-                std::vector<char> receivedData(tempBuffer->begin(),
-                                               tempBuffer->begin() + bytesRead);
-                dataAcceptor_->processRawData(receivedData);
-                processNextData();
-              } else {
-                if (error == boost::asio::error::eof) {
-                  std::cout << "Connection closed by client" << std::endl;
-                  return;
-                } else {
-                  std::cerr << "Error reading data: " + error.message()
-                            << std::endl;
-                  return;
-                }
-              }
-            } catch (const std::exception &ex) {
-              std::cerr << "Exception in async handler: " << ex.what()
+  acceptor_.async_accept(
+      socket_, [this](const boost::system::error_code &error) {
+        try {
+          if (error) {
+            if (error != boost::asio::error::operation_aborted) {
+              std::cerr << "Error accepting connection: " + error.message()
                         << std::endl;
-              return;
             }
-          });
-    } catch (const std::exception &ex) {
-      std::cerr << "Exception in processNextData: " << ex.what() << std::endl;
+            return;
+          }
+          socket_.set_option(boost::asio::ip::tcp::no_delay(true));
+          profile_.applySocketOptions(socket_);
+          profile_.applyThreadOptions();
+#ifdef __linux__
+          if (profile_.kernelTimestamps) {
+            readWithKernelTimestamps();
+            return;
+          }
+#endif
+          readNextData();
+        } catch (const std::exception &ex) {
+          std::cerr << "Exception in accept handler: " << ex.what()
+                    << std::endl;
+        }
+      });
+  ioContext_.run();
+}
+
+void AsioReceiver::stop() {
+  boost::asio::post(ioContext_, [this]() {
+    boost::system::error_code ignored;
+    acceptor_.close(ignored);
+    socket_.close(ignored);
+  });
+}
+
+void AsioReceiver::readNextData() {
+  VT_TRACE_BEGIN("async_read_some");
+  socket_.async_read_some(
+      boost::asio::buffer(readBuffer_),
+      makeRecyclingHandler(readHandlerMemory_,
+                           [this](const boost::system::error_code &error,
+                                  std::size_t bytesRead) {
+                             onDataRead(error, bytesRead);
+                           }));
+}
+
+void AsioReceiver::onDataRead(const boost::system::error_code &error,
+                              std::size_t bytesRead) {
+  VT_TRACE_END("async_read_some");
+  VT_TRACE_SCOPE("onDataRead");
+  try {
+    if (!error && bytesRead > 0) {
+      receivedData_.assign(readBuffer_.begin(),
+                           readBuffer_.begin() + bytesRead);
+      dataAcceptor_->processRawData(receivedData_);
+      profile_.rearmQuickAck(socket_);
+      readNextData();
+    } else if (error == boost::asio::error::eof) {
+      std::cout << "Connection closed by client" << std::endl;
+    } else if (error == boost::asio::error::operation_aborted) {
+      std::cout << "Receiver stopped" << std::endl;
+    } else {
+      std::cerr << "Error reading data: " + error.message() << std::endl;
+    }
+  } catch (const std::exception &ex) {
+    std::cerr << "Exception in async handler: " << ex.what() << std::endl;
+  }
+}
+
+#ifdef __linux__
+void AsioReceiver::readWithKernelTimestamps() {
+  socket_.async_wait(
+      tcp::socket::wait_read,
+      makeRecyclingHandler(readHandlerMemory_,
+                           [this](const boost::system::error_code &error) {
+                             onReadableWithKernelTimestamps(error);
+                           }));
+}
+
+void AsioReceiver::onReadableWithKernelTimestamps(
+    const boost::system::error_code &error) {
+  VT_TRACE_SCOPE("onReadableWithKernelTimestamps");
+  try {
+    if (error == boost::asio::error::operation_aborted) {
+      std::cout << "Receiver stopped" << std::endl;
       return;
     }
-  };
-  processNextData();
-  ioContext_.run();
+    if (error) {
+      std::cerr << "Error reading data: " + error.message() << std::endl;
+      return;
+    }
+
+    iovec iov{readBuffer_.data(), readBuffer_.size()};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(scm_timestamping))];
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t bytesRead =
+        recvmsg(socket_.native_handle(), &message, MSG_DONTWAIT);
+    if (bytesRead < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        readWithKernelTimestamps();
+        return;
+      }
+      std::cerr << "Error reading data: " << std::strerror(errno)
+                << std::endl;
+      return;
+    }
+    if (bytesRead == 0) {
+      std::cout << "Connection closed by client" << std::endl;
+      return;
+    }
+
+    auto arrivalTime = std::chrono::system_clock::now();
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET &&
+          cmsg->cmsg_type == SCM_TIMESTAMPING) {
+        const auto *timestamps =
+            reinterpret_cast<const scm_timestamping *>(CMSG_DATA(cmsg));
+        const timespec &rxTime = timestamps->ts[0];
+        arrivalTime = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::seconds(rxTime.tv_sec) +
+                std::chrono::nanoseconds(rxTime.tv_nsec)));
+      }
+    }
+
+    receivedData_.assign(readBuffer_.begin(), readBuffer_.begin() + bytesRead);
+    dataAcceptor_->processRawData(receivedData_, arrivalTime);
+    profile_.rearmQuickAck(socket_);
+    readWithKernelTimestamps();
+  } catch (const std::exception &ex) {
+    std::cerr << "Exception in async handler: " << ex.what() << std::endl;
+  }
+}
+#else
+void AsioReceiver::readWithKernelTimestamps() {}
+
+void AsioReceiver::onReadableWithKernelTimestamps(
+    const boost::system::error_code &) {}
+#endif
+
+uint16_t AsioReceiver::getPort() const {
+  return acceptor_.local_endpoint().port();
 }
 
 size_t AsioReceiver::getDataUnitsReceived() const {
@@ -2,75 +2,451 @@
 #include "DataProvider.hpp"
 #include "DataFile.hpp"
 #include "DataUnitConverter.hpp"
+#include "TimestampWriter.hpp"
+#include "Constants.hpp"
+#include "HandlerAllocator.hpp"
+#include "Trace.hpp"
+#include <algorithm>
 #include <iostream>
 #include <chrono>
+#include <limits>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
 
 using boost::asio::ip::tcp;
 
+AsioSender::Stream::Stream(uint16_t streamId,
+                           std::unique_ptr<IDataProvider> provider,
+                           boost::asio::io_context &ioContext)
+    : id(streamId), dataProvider(std::move(provider)), timer(ioContext) {}
+
 AsioSender::AsioSender(const std::string &destinationIp,
                        uint16_t destinationPort,
-                       std::unique_ptr<DataProvider> dataProvider)
-    : dataProvider_(std::move(dataProvider)), socket_(ioContext_),
-      timer_(ioContext_) {
+                       std::unique_ptr<IDataProvider> dataProvider,
+                       TuningProfile profile)
+    : profile_(std::move(profile)), socket_(ioContext_), multiplexed_(false) {
+  streams_.push_back(
+      std::make_unique<Stream>(0, std::move(dataProvider), ioContext_));
+  connect(destinationIp, destinationPort);
+}
+
+AsioSender::AsioSender(
+    const std::string &destinationIp, uint16_t destinationPort,
+    std::vector<std::unique_ptr<IDataProvider>> dataProviders,
+    TuningProfile profile)
+    : profile_(std::move(profile)), socket_(ioContext_), multiplexed_(true) {
+  if (dataProviders.empty() ||
+      dataProviders.size() > std::numeric_limits<uint16_t>::max() + 1u) {
+    throw std::runtime_error("Multiplexed sender needs 1 to 65536 streams, got " +
+                             std::to_string(dataProviders.size()));
+  }
+  for (size_t i = 0; i < dataProviders.size(); ++i) {
+    streams_.push_back(std::make_unique<Stream>(
+        static_cast<uint16_t>(i), std::move(dataProviders[i]), ioContext_));
+  }
+  connect(destinationIp, destinationPort);
+}
+
+AsioSender::~AsioSender() = default;
+
+void AsioSender::connect(const std::string &destinationIp,
+                         uint16_t destinationPort) {
   boost::asio::ip::tcp::resolver resolver(ioContext_);
   auto endpoints =
       resolver.resolve(destinationIp, std::to_string(destinationPort));
   boost::asio::connect(socket_, endpoints);
   socket_.set_option(boost::asio::ip::tcp::no_delay(true));
+  profile_.applySocketOptions(socket_);
+}
+
+void AsioSender::setTxTimestampWriter(
+    std::unique_ptr<ITimestampWriter> writer) {
+  txTimestampWriter_ = std::move(writer);
+}
+
+void AsioSender::setStreamDelay(uint16_t streamId,
+                                std::chrono::milliseconds delay) {
+  if (streamId >= streams_.size()) {
+    throw std::runtime_error("Unknown stream ID: " + std::to_string(streamId));
+  }
+  streams_[streamId]->delay = delay;
+}
+
+void AsioSender::setQueuePolicy(size_t capacity,
+                                std::chrono::milliseconds maxLatency) {
+  sendQueue_ = SendQueue(capacity, maxLatency);
+  paced_ = capacity > 0 || maxLatency.count() > 0;
+}
+
+size_t AsioSender::warmUp(size_t framesPerStream) {
+  size_t prefetched = 0;
+  for (auto &stream : streams_) {
+    prefetched += stream->dataProvider->prefetch(framesPerStream);
+  }
+  return prefetched;
 }
 
-void AsioSender::startTransport(std::chrono::milliseconds delay) {
+std::optional<std::chrono::microseconds>
+AsioSender::getTimeToFirstFrame() const {
+  if (!firstFrameSentAt_.has_value()) {
+    return std::nullopt;
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      firstFrameSentAt_.value() - transportStartedAt_);
+}
+
+void AsioSender::startTransport(std::chrono::microseconds delay) {
   delay_ = delay;
-  std::function<void()> processNextData = [this, &processNextData]() {
+  publishStats();
+  profile_.applyThreadOptions();
+  activeStreams_ = streams_.size();
+  transportStartedAt_ = std::chrono::steady_clock::now();
+  for (auto &stream : streams_) {
+    stream->nextDue = transportStartedAt_;
+    processNextData(*stream);
+  }
+  ioContext_.run();
+}
+
+void AsioSender::processNextData(Stream &stream) {
+  VT_TRACE_SCOPE("processNextData");
+  try {
+    auto data = stream.dataProvider->getNextData();
+    if (!data.has_value()) {
+      stream.finished = true;
+      --activeStreams_;
+      finishIfDone();
+      return;
+    }
+
+    DataUnitConverter converter;
+    auto flags = converter.decodeFlags(data->data(), data->size());
+    bool keyframe = flags.value_or(0) & Constants::FlagKeyframe;
+    auto frame = std::make_shared<std::vector<char>>(std::move(data.value()));
+    if (multiplexed_) {
+      char streamHeader[Constants::StreamIdSizeBytes] = {
+          static_cast<char>((stream.id >> 8) & 0xFF),
+          static_cast<char>(stream.id & 0xFF)};
+      frame->insert(frame->begin(), std::begin(streamHeader),
+                    std::end(streamHeader));
+    }
+    sendQueue_.push(std::move(frame), keyframe);
+    // With a queue policy, frames are produced on a fixed clock whether or
+    // not the socket keeps up, so a slow link shows up as queue pressure
+    // instead of drift. Without one nothing would bound the queue, so the
+    // next frame waits for this one to be written.
+    if (paced_) {
+      scheduleNextData(stream);
+    } else {
+      awaitingWrite_.push_back(&stream);
+    }
+    writeQueuedFrames();
+    publishStats();
+  } catch (const std::exception &ex) {
+    std::cerr << "Exception in processNextData: " << ex.what() << std::endl;
+    // A failed stream ends here; the others keep going.
+    if (!stream.finished) {
+      stream.finished = true;
+      stream.timer.cancel();
+      --activeStreams_;
+    }
+    finishIfDone();
+  }
+}
+
+void AsioSender::scheduleNextData(Stream &stream) {
+  // After a stall the clock restarts from now rather than firing every
+  // missed frame at once.
+  stream.nextDue = std::max(stream.nextDue + stream.delay.value_or(delay_),
+                            std::chrono::steady_clock::now());
+  stream.timer.expires_at(stream.nextDue);
+  stream.timer.async_wait(makeRecyclingHandler(
+      stream.timerHandlerMemory,
+      [this, &stream](const boost::system::error_code &timerError) {
+        try {
+          if (!timerError) {
+            processNextData(stream);
+          } else if (timerError != boost::asio::error::operation_aborted) {
+            std::cerr << "Timer error: " << timerError.message() << std::endl;
+          }
+        } catch (const std::exception &ex) {
+          std::cerr << "Exception in timer handler: " << ex.what()
+                    << std::endl;
+        }
+      }));
+}
+
+void AsioSender::writeQueuedFrames() {
+  if (writing_) {
+    return;
+  }
+  auto queued = sendQueue_.pop();
+  if (!queued.has_value()) {
+    return;
+  }
+  writing_ = true;
+  VT_TRACE_BEGIN("writeFrame");
+  size_t frameSize = queued->frame->size();
+  writeFrame(queued->frame, [this, frameSize](
+                                const boost::system::error_code &error) {
+    VT_TRACE_END("writeFrame");
+    writing_ = false;
     try {
-      auto data = dataProvider_->getNextData();
-      if (data.has_value()) {
-        boost::asio::async_write(
-            socket_, boost::asio::buffer(data.value()),
-            [this, &processNextData](const boost::system::error_code &error,
-                                     std::size_t bytesTransferred) {
-              try {
-                if (!error) {
-                  timer_.expires_after(delay_);
-                  timer_.async_wait(
-                      [this, &processNextData](
-                          const boost::system::error_code &timerError) {
-                        try {
-                          if (!timerError) {
-                            processNextData();
-                          } else {
-                            std::cerr << "Timer error: " << timerError.message()
-                                      << std::endl;
-                            return;
-                          }
-                        } catch (const std::exception &ex) {
-                          std::cerr
-                              << "Exception in timer handler: " << ex.what()
-                              << std::endl;
-                          return;
-                        }
-                      });
-                } else {
-                  std::cerr << "Error sending data: " + error.message()
-                            << std::endl;
-                  return;
-                }
-              } catch (const std::exception &ex) {
-                std::cerr << "Exception in async_write handler: " << ex.what()
-                          << std::endl;
-                return;
-              }
-            });
-      } else {
-        std::cout << "Transport completed - no more data available"
-                  << std::endl;
+      if (error == boost::asio::error::operation_aborted) {
+        std::cout << "Sender stopped" << std::endl;
         return;
       }
+      if (error) {
+        std::cerr << "Error sending data: " + error.message() << std::endl;
+        stop();
+        return;
+      }
+      if (!firstFrameSentAt_.has_value()) {
+        firstFrameSentAt_ = std::chrono::steady_clock::now();
+      }
+      framesWritten_++;
+      bytesWritten_ += frameSize;
+      if (!awaitingWrite_.empty()) {
+        Stream *written = awaitingWrite_.front();
+        awaitingWrite_.pop_front();
+        scheduleNextData(*written);
+      }
+      writeQueuedFrames();
+      publishStats();
+      finishIfDone();
     } catch (const std::exception &ex) {
-      std::cerr << "Exception in processNextData: " << ex.what() << std::endl;
+      std::cerr << "Exception in async_write handler: " << ex.what()
+                << std::endl;
+    }
+  });
+}
+
+void AsioSender::stop() {
+  boost::asio::post(ioContext_, [this]() {
+    for (auto &stream : streams_) {
+      stream->timer.cancel();
+    }
+    drainTimer_.cancel();
+    sendQueue_.clear();
+    awaitingWrite_.clear();
+    boost::system::error_code ignored;
+    socket_.close(ignored);
+  });
+}
+
+void AsioSender::setInterval(std::chrono::microseconds interval) {
+  boost::asio::post(ioContext_, [this, interval]() {
+    delay_ = interval;
+    for (auto &stream : streams_) {
+      stream->delay.reset();
+    }
+    publishStats();
+  });
+}
+
+AsioSender::Stats AsioSender::getStats() const {
+  std::lock_guard<std::mutex> lock(statsMutex_);
+  return stats_;
+}
+
+void AsioSender::publishStats() {
+  std::lock_guard<std::mutex> lock(statsMutex_);
+  stats_.framesSent = framesWritten_;
+  stats_.bytesSent = bytesWritten_;
+  stats_.droppedFrames = sendQueue_.getDroppedFrames();
+  stats_.droppedBytes = sendQueue_.getDroppedBytes();
+  stats_.queuedFrames = sendQueue_.size();
+  stats_.interval = delay_;
+}
+
+void AsioSender::finishIfDone() {
+  if (activeStreams_ == 0 && !writing_ && sendQueue_.empty()) {
+    finishTransport();
+  }
+}
+
+void AsioSender::finishTransport() {
+  drainErrorQueue(std::chrono::steady_clock::now() + std::chrono::seconds(1));
+}
+
+void AsioSender::reportTransport() {
+  std::cout << "Transport completed - no more data available" << std::endl;
+  if (sendQueue_.getDroppedFrames() > 0) {
+    std::cout << "Dropped frames: " << sendQueue_.getDroppedFrames() << " ("
+              << sendQueue_.getDroppedBytes() << " bytes)" << std::endl;
+  }
+  if (profile_.zeroCopy) {
+    std::cout << "Zero-copy sends: " << zeroCopySends_
+              << ", copied by kernel: " << zeroCopyCopied_ << std::endl;
+  }
+}
+
+void AsioSender::writeFrame(std::shared_ptr<std::vector<char>> frame,
+                            WriteHandler onWritten) {
+#ifdef __linux__
+  if (profile_.zeroCopy || profile_.kernelTimestamps) {
+    writeFrameNative(std::move(frame), 0, std::move(onWritten));
+    return;
+  }
+#endif
+  boost::asio::async_write(
+      socket_, boost::asio::buffer(*frame),
+      makeRecyclingHandler(writeHandlerMemory_,
+                           [frame, onWritten = std::move(onWritten)](
+                               const boost::system::error_code &error,
+                               std::size_t) { onWritten(error); }));
+}
+
+#ifdef __linux__
+void AsioSender::writeFrameNative(std::shared_ptr<std::vector<char>> frame,
+                                  size_t offset, WriteHandler onWritten) {
+  int fd = socket_.native_handle();
+  bool zeroCopy = profile_.zeroCopy;
+  while (offset < frame->size()) {
+    int flags = MSG_DONTWAIT | MSG_NOSIGNAL | (zeroCopy ? MSG_ZEROCOPY : 0);
+    ssize_t sent =
+        ::send(fd, frame->data() + offset, frame->size() - offset, flags);
+    if (sent < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        reapErrorQueue();
+        socket_.async_wait(
+            tcp::socket::wait_write,
+            makeRecyclingHandler(
+                writeHandlerMemory_,
+                [this, frame, offset, onWritten = std::move(onWritten)](
+                    const boost::system::error_code &error) mutable {
+                  if (error) {
+                    onWritten(error);
+                    return;
+                  }
+                  writeFrameNative(std::move(frame), offset,
+                                   std::move(onWritten));
+                }));
+        return;
+      }
+      if (errno == ENOBUFS && zeroCopy) {
+        // Pinned-page budget (optmem_max) exhausted, copy this frame instead.
+        reapErrorQueue();
+        zeroCopy = false;
+        continue;
+      }
+      onWritten(boost::system::error_code(errno, boost::system::system_category()));
       return;
     }
-  };
-  processNextData();
-  ioContext_.run();
-}
\ No newline at end of file
+    offset += static_cast<size_t>(sent);
+    bytesSent_ += static_cast<uint64_t>(sent);
+    if (zeroCopy) {
+      zeroCopyInFlight_.push_back({zeroCopySends_++, frame});
+    }
+  }
+  if (profile_.kernelTimestamps && txTimestampWriter_) {
+    size_t streamHeaderBytes = multiplexed_ ? Constants::StreamIdSizeBytes : 0;
+    pendingTxTimestamps_.push_back(
+        {bytesSent_ - 1,
+         static_cast<uint32_t>(frame->size() - streamHeaderBytes)});
+  }
+  reapErrorQueue();
+  onWritten(boost::system::error_code());
+}
+
+void AsioSender::reapErrorQueue() {
+  int fd = socket_.native_handle();
+  for (;;) {
+    alignas(cmsghdr) char control[512];
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+      return;
+    }
+
+    const scm_timestamping *timestamps = nullptr;
+    const sock_extended_err *extendedError = nullptr;
+    for (cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET &&
+          cmsg->cmsg_type == SCM_TIMESTAMPING) {
+        timestamps =
+            reinterpret_cast<const scm_timestamping *>(CMSG_DATA(cmsg));
+      } else if ((cmsg->cmsg_level == SOL_IP &&
+                  cmsg->cmsg_type == IP_RECVERR) ||
+                 (cmsg->cmsg_level == SOL_IPV6 &&
+                  cmsg->cmsg_type == IPV6_RECVERR)) {
+        extendedError =
+            reinterpret_cast<const sock_extended_err *>(CMSG_DATA(cmsg));
+      }
+    }
+    if (extendedError == nullptr) {
+      continue;
+    }
+
+    if (extendedError->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+      if (extendedError->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+        zeroCopyCopied_ += extendedError->ee_data - extendedError->ee_info + 1;
+      }
+      while (!zeroCopyInFlight_.empty() &&
+             zeroCopyInFlight_.front().sendId <= extendedError->ee_data) {
+        zeroCopyInFlight_.pop_front();
+      }
+    } else if (extendedError->ee_origin == SO_EE_ORIGIN_TIMESTAMPING &&
+               timestamps != nullptr && txTimestampWriter_) {
+      // For TCP the timestamp key is the offset of the last byte sent.
+      uint64_t key = extendedError->ee_data;
+      while (!pendingTxTimestamps_.empty() &&
+             static_cast<uint32_t>(
+                 pendingTxTimestamps_.front().lastByteOffset) <= key) {
+        auto pending = pendingTxTimestamps_.front();
+        pendingTxTimestamps_.pop_front();
+        if (static_cast<uint32_t>(pending.lastByteOffset) != key) {
+          continue;
+        }
+        const timespec &txTime = timestamps->ts[0];
+        auto timestamp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::seconds(txTime.tv_sec) +
+                std::chrono::nanoseconds(txTime.tv_nsec)));
+        DataUnit unit;
+        unit.length = pending.length - Constants::HeaderSizeBytes;
+        txTimestampWriter_->write(unit, timestamp);
+      }
+    }
+  }
+}
+
+void AsioSender::drainErrorQueue(
+    std::chrono::steady_clock::time_point deadline) {
+  reapErrorQueue();
+  bool owed = !zeroCopyInFlight_.empty() ||
+              (txTimestampWriter_ && !pendingTxTimestamps_.empty());
+  if (!owed || std::chrono::steady_clock::now() >= deadline) {
+    reportTransport();
+    return;
+  }
+  drainTimer_.expires_after(std::chrono::milliseconds(1));
+  drainTimer_.async_wait(
+      [this, deadline](const boost::system::error_code &error) {
+        if (error) {
+          return; // stopped
+        }
+        drainErrorQueue(deadline);
+      });
+}
+#else
+void AsioSender::writeFrameNative(std::shared_ptr<std::vector<char>> frame,
+                                  size_t, WriteHandler onWritten) {
+  writeFrame(std::move(frame), std::move(onWritten));
+}
+
+void AsioSender::reapErrorQueue() {}
+
+void AsioSender::drainErrorQueue(std::chrono::steady_clock::time_point) {
+  reportTransport();
+}
+#endif
@@ -0,0 +1,353 @@
+#include "CaptureAnalyzer.hpp"
+#include "Constants.hpp"
+#include "DataUnitConverter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace {
+// Runs fn(begin, end, chunk) over [0, count) split into one chunk per thread.
+template <typename Function>
+void parallelChunks(size_t count, unsigned threads, Function fn) {
+  size_t chunks = std::max<size_t>(1, std::min<size_t>(threads, count));
+  size_t chunkSize = (count + chunks - 1) / std::max<size_t>(chunks, 1);
+  std::vector<std::thread> workers;
+  for (size_t chunk = 1; chunk < chunks; ++chunk) {
+    size_t begin = std::min(count, chunk * chunkSize);
+    size_t end = std::min(count, begin + chunkSize);
+    workers.emplace_back(fn, begin, end, chunk);
+  }
+  fn(0, std::min(count, chunkSize), 0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+uint64_t fnv1a(const char *data, size_t size) {
+  uint64_t hash = 1469598103934665603ULL;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date.
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+  unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  unsigned dayOfEra =
+      yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+}
+
+bool parseDigits(const char *&cursor, const char *end, size_t count,
+                 int64_t &value) {
+  if (static_cast<size_t>(end - cursor) < count) {
+    return false;
+  }
+  value = 0;
+  for (size_t i = 0; i < count; ++i, ++cursor) {
+    if (*cursor < '0' || *cursor > '9') {
+      return false;
+    }
+    value = value * 10 + (*cursor - '0');
+  }
+  return true;
+}
+
+// "YYYY-MM-DD HH:MM:SS.ffffff - Video Unit: N bytes (length: L)"
+bool parseTimestampLine(const char *line, const char *end,
+                        CaptureAnalyzer::TimestampRecord &record) {
+  int64_t year, month, day, hour, minute, second;
+  const char *cursor = line;
+  auto expect = [&cursor, end](char c) {
+    return cursor < end && *cursor++ == c;
+  };
+  if (!parseDigits(cursor, end, 4, year) || !expect('-') ||
+      !parseDigits(cursor, end, 2, month) || !expect('-') ||
+      !parseDigits(cursor, end, 2, day) || !expect(' ') ||
+      !parseDigits(cursor, end, 2, hour) || !expect(':') ||
+      !parseDigits(cursor, end, 2, minute) || !expect(':') ||
+      !parseDigits(cursor, end, 2, second) || !expect('.')) {
+    return false;
+  }
+
+  int64_t fraction = 0;
+  int digits = 0;
+  for (; cursor < end && *cursor >= '0' && *cursor <= '9'; ++cursor) {
+    if (digits < 6) {
+      fraction = fraction * 10 + (*cursor - '0');
+      ++digits;
+    }
+  }
+  if (digits == 0) {
+    return false;
+  }
+  for (; digits < 6; ++digits) {
+    fraction *= 10;
+  }
+
+  int64_t days = daysFromCivil(year, static_cast<unsigned>(month),
+                               static_cast<unsigned>(day));
+  record.microseconds =
+      ((days * 24 + hour) * 60 + minute) * 60000000LL + second * 1000000LL +
+      fraction;
+
+  static const char marker[] = "Unit: ";
+  const char *unit = std::search(cursor, end, marker, marker + 6);
+  if (unit == end) {
+    return false;
+  }
+  record.bytes = 0;
+  for (cursor = unit + 6; cursor < end && *cursor >= '0' && *cursor <= '9';
+       ++cursor) {
+    record.bytes = record.bytes * 10 + static_cast<uint32_t>(*cursor - '0');
+  }
+  return true;
+}
+
+std::vector<double> percentiles(std::vector<double> values) {
+  std::vector<double> result;
+  if (values.empty()) {
+    return result;
+  }
+  std::sort(values.begin(), values.end());
+  for (double percentile : CaptureAnalyzer::Percentiles) {
+    size_t rank = static_cast<size_t>(
+        std::ceil(percentile / 100.0 * static_cast<double>(values.size())));
+    result.push_back(values[rank == 0 ? 0 : rank - 1]);
+  }
+  return result;
+}
+} // namespace
+
+CaptureAnalyzer::CaptureAnalyzer(unsigned threads)
+    : threads_(threads != 0 ? threads
+                            : std::max(1u, std::thread::hardware_concurrency())) {}
+
+CaptureAnalyzer::FramingResult
+CaptureAnalyzer::indexFrames(const char *data, size_t size) const {
+  // Frame boundaries are only known by walking the length prefixes, so the
+  // index is built sequentially; it touches one header per frame.
+  FramingResult result;
+  DataUnitConverter converter;
+  uint64_t offset = 0;
+  while (offset < size) {
+    auto length = converter.decodeHeader(data + offset, size - offset);
+    if (!length.has_value()) {
+      result.error = "truncated header at offset " + std::to_string(offset);
+      break;
+    }
+    if (length.value() >
+        Constants::MaxPacketSize - Constants::HeaderSizeBytes) {
+      result.error = "frame " + std::to_string(result.frames.size()) +
+                     " at offset " + std::to_string(offset) +
+                     " declares oversized length " +
+                     std::to_string(length.value());
+      break;
+    }
+    uint64_t frameEnd = offset + Constants::HeaderSizeBytes + length.value();
+    if (frameEnd > size) {
+      result.error = "frame " + std::to_string(result.frames.size()) +
+                     " at offset " + std::to_string(offset) +
+                     " is truncated (" + std::to_string(size - offset) +
+                     " of " + std::to_string(frameEnd - offset) + " bytes)";
+      break;
+    }
+    result.frames.push_back({offset, length.value()});
+    offset = frameEnd;
+  }
+  result.validBytes = offset;
+  return result;
+}
+
+uint64_t CaptureAnalyzer::checksum(const char *data,
+                                   const FramingResult &framing) const {
+  std::vector<uint64_t> frameHashes(framing.frames.size());
+  parallelChunks(framing.frames.size(), threads_,
+                 [&](size_t begin, size_t end, size_t) {
+                   for (size_t i = begin; i < end; ++i) {
+                     const auto &frame = framing.frames[i];
+                     frameHashes[i] =
+                         fnv1a(data + frame.offset,
+                               Constants::HeaderSizeBytes + frame.length);
+                   }
+                 });
+
+  uint64_t digest = 1469598103934665603ULL;
+  for (uint64_t hash : frameHashes) {
+    digest = (digest ^ hash) * 1099511628211ULL;
+  }
+  return digest;
+}
+
+CaptureAnalyzer::Divergence CaptureAnalyzer::compareFrames(
+    const char *capture, const FramingResult &captured, const char *source,
+    const FramingResult &sourceFraming) const {
+  size_t common = std::min(captured.frames.size(), sourceFraming.frames.size());
+  std::vector<size_t> firstMismatch(threads_,
+                                    std::numeric_limits<size_t>::max());
+  parallelChunks(common, threads_, [&](size_t begin, size_t end, size_t chunk) {
+    for (size_t i = begin; i < end; ++i) {
+      const auto &a = captured.frames[i];
+      const auto &b = sourceFraming.frames[i];
+      if (a.length != b.length ||
+          std::memcmp(capture + a.offset, source + b.offset,
+                      Constants::HeaderSizeBytes + a.length) != 0) {
+        firstMismatch[chunk] = i;
+        return;
+      }
+    }
+  });
+
+  Divergence divergence;
+  size_t index = *std::min_element(firstMismatch.begin(), firstMismatch.end());
+  if (index != std::numeric_limits<size_t>::max()) {
+    const auto &a = captured.frames[index];
+    const auto &b = sourceFraming.frames[index];
+    divergence.identical = false;
+    divergence.frameIndex = index;
+    divergence.captureOffset = a.offset;
+    if (a.length != b.length) {
+      divergence.reason = "length " + std::to_string(a.length) +
+                          " != source length " + std::to_string(b.length);
+    } else {
+      size_t byte = 0;
+      while (capture[a.offset + Constants::HeaderSizeBytes + byte] ==
+             source[b.offset + Constants::HeaderSizeBytes + byte]) {
+        ++byte;
+      }
+      divergence.reason = "payload differs at byte " + std::to_string(byte);
+    }
+  } else if (captured.frames.size() != sourceFraming.frames.size()) {
+    divergence.identical = false;
+    divergence.frameIndex = common;
+    divergence.captureOffset = captured.validBytes;
+    divergence.reason =
+        captured.frames.size() < sourceFraming.frames.size()
+            ? "capture ends, source has " +
+                  std::to_string(sourceFraming.frames.size() - common) +
+                  " more frames"
+            : "capture has " + std::to_string(captured.frames.size() - common) +
+                  " extra frames";
+  }
+  return divergence;
+}
+
+std::vector<CaptureAnalyzer::TimestampRecord>
+CaptureAnalyzer::parseTimestampLog(const char *data, size_t size) const {
+  // Split at line boundaries so every chunk parses whole lines.
+  std::vector<size_t> boundaries = {0};
+  for (unsigned chunk = 1; chunk < threads_; ++chunk) {
+    size_t position = std::max(boundaries.back(), size * chunk / threads_);
+    const char *newline = static_cast<const char *>(
+        std::memchr(data + position, '\n', size - position));
+    boundaries.push_back(newline ? static_cast<size_t>(newline - data) + 1
+                                 : size);
+  }
+  boundaries.push_back(size);
+
+  std::vector<std::vector<TimestampRecord>> parts(boundaries.size() - 1);
+  parallelChunks(parts.size(), threads_, [&](size_t begin, size_t end, size_t) {
+    for (size_t part = begin; part < end; ++part) {
+      const char *cursor = data + boundaries[part];
+      const char *partEnd = data + boundaries[part + 1];
+      while (cursor < partEnd) {
+        const char *lineEnd = static_cast<const char *>(
+            std::memchr(cursor, '\n', static_cast<size_t>(partEnd - cursor)));
+        if (lineEnd == nullptr) {
+          lineEnd = partEnd;
+        }
+        TimestampRecord record;
+        if (parseTimestampLine(cursor, lineEnd, record)) {
+          parts[part].push_back(record);
+        }
+        cursor = lineEnd + 1;
+      }
+    }
+  });
+
+  std::vector<TimestampRecord> records;
+  for (auto &part : parts) {
+    records.insert(records.end(), part.begin(), part.end());
+  }
+  return records;
+}
+
+CaptureAnalyzer::TimingReport CaptureAnalyzer::analyzeTiming(
+    const std::vector<TimestampRecord> &records,
+    std::chrono::microseconds nominalInterval,
+    std::chrono::milliseconds window) const {
+  TimingReport report;
+  report.units = records.size();
+  for (const auto &record : records) {
+    report.totalBytes += record.bytes;
+  }
+  // A clock step or a merged log can move a timestamp backwards; such units
+  // are left out of the interval and window statistics.
+  std::vector<size_t> ordered;
+  ordered.reserve(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (!ordered.empty() &&
+        records[i].microseconds < records[ordered.back()].microseconds) {
+      ++report.outOfOrder;
+      continue;
+    }
+    ordered.push_back(i);
+  }
+  if (ordered.size() < 2) {
+    return report;
+  }
+
+  double nominalMs = static_cast<double>(nominalInterval.count()) / 1000.0;
+  double gapThresholdMs = 2 * nominalMs;
+  std::vector<double> intervals(ordered.size() - 1);
+  std::vector<double> jitter(ordered.size() - 1);
+  for (size_t i = 1; i < ordered.size(); ++i) {
+    double interval =
+        static_cast<double>(records[ordered[i]].microseconds -
+                            records[ordered[i - 1]].microseconds) /
+        1000.0;
+    intervals[i - 1] = interval;
+    jitter[i - 1] = std::abs(interval - nominalMs);
+    if (interval > gapThresholdMs) {
+      ++report.gapCount;
+      if (interval > report.longestGapMs) {
+        report.longestGapMs = interval;
+        report.longestGapUnit = ordered[i];
+      }
+    }
+  }
+  int64_t start = records[ordered.front()].microseconds;
+  int64_t last = records[ordered.back()].microseconds;
+  report.durationMs = static_cast<double>(last - start) / 1000.0;
+  report.intervalMs = percentiles(std::move(intervals));
+  report.jitterMs = percentiles(std::move(jitter));
+
+  int64_t windowMicros = std::max<int64_t>(
+      1, std::chrono::duration_cast<std::chrono::microseconds>(window).count());
+  std::vector<uint64_t> windowBytes(
+      static_cast<size_t>((last - start) / windowMicros) + 1);
+  for (size_t i : ordered) {
+    windowBytes[static_cast<size_t>((records[i].microseconds - start) /
+                                    windowMicros)] += records[i].bytes;
+  }
+  double windowSeconds = static_cast<double>(windowMicros) / 1e6;
+  report.windowCount = windowBytes.size();
+  report.minWindowMBps = std::numeric_limits<double>::max();
+  double sum = 0;
+  for (uint64_t bytes : windowBytes) {
+    double rate = static_cast<double>(bytes) / 1e6 / windowSeconds;
+    report.minWindowMBps = std::min(report.minWindowMBps, rate);
+    report.maxWindowMBps = std::max(report.maxWindowMBps, rate);
+    sum += rate;
+  }
+  report.meanWindowMBps = sum / static_cast<double>(windowBytes.size());
+  return report;
+}
@@ -0,0 +1,172 @@
+#include "CaptureJournal.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+constexpr char Magic[4] = {'V', 'T', 'J', '1'};
+constexpr size_t ChecksumOffset = CaptureJournal::RecordSizeBytes - 4;
+
+using Record = std::array<unsigned char, CaptureJournal::RecordSizeBytes>;
+
+void putUint64(unsigned char *out, uint64_t value) {
+  for (int i = 7; i >= 0; --i) {
+    out[7 - i] = static_cast<unsigned char>(value >> (8 * i));
+  }
+}
+
+uint64_t getUint64(const unsigned char *in) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value = (value << 8) | in[i];
+  }
+  return value;
+}
+
+uint32_t checksum(const Record &record) {
+  return static_cast<uint32_t>(
+      crc32(0L, record.data(), static_cast<uInt>(ChecksumOffset)));
+}
+
+std::optional<CaptureJournal::Commit> decode(const Record &record) {
+  if (std::memcmp(record.data(), Magic, sizeof(Magic)) != 0) {
+    return std::nullopt;
+  }
+  uint32_t stored = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    stored = (stored << 8) | record[ChecksumOffset + i];
+  }
+  if (stored != checksum(record)) {
+    return std::nullopt; // torn or never completed
+  }
+  CaptureJournal::Commit commit;
+  commit.sequence = getUint64(record.data() + 4);
+  commit.frames = getUint64(record.data() + 12);
+  commit.dataBytes = getUint64(record.data() + 20);
+  commit.timestampBytes = getUint64(record.data() + 28);
+  commit.committedAt = std::chrono::system_clock::time_point(
+      std::chrono::microseconds(getUint64(record.data() + 36)));
+  return commit;
+}
+
+uint64_t truncateTo(const std::string &fileName, uint64_t size, bool dryRun,
+                    bool &truncated) {
+  if (!std::filesystem::exists(fileName)) {
+    if (size > 0) {
+      throw std::runtime_error("Missing " + fileName + ", committed with " +
+                               std::to_string(size) + " bytes");
+    }
+    return 0;
+  }
+  uint64_t found = std::filesystem::file_size(fileName);
+  if (found < size) {
+    throw std::runtime_error(fileName + " has " + std::to_string(found) +
+                             " bytes, fewer than the " + std::to_string(size) +
+                             " committed");
+  }
+  if (found > size) {
+    truncated = true;
+    if (!dryRun) {
+      std::filesystem::resize_file(fileName, size);
+    }
+  }
+  return found;
+}
+} // namespace
+
+CaptureJournal::CaptureJournal(const std::string &dataFileName)
+    : path_(journalPath(dataFileName)) {
+  fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0) {
+    throw std::runtime_error("Could not open journal " + path_ + ": " +
+                             std::strerror(errno));
+  }
+  // Both slots exist from the start, so a commit never changes the size.
+  if (::ftruncate(fd_, RecordSizeBytes * SlotCount) != 0) {
+    throw std::runtime_error("Could not size journal " + path_ + ": " +
+                             std::strerror(errno));
+  }
+}
+
+CaptureJournal::~CaptureJournal() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+void CaptureJournal::commit(uint64_t frames, uint64_t dataBytes,
+                            uint64_t timestampBytes) {
+  Record record{};
+  std::memcpy(record.data(), Magic, sizeof(Magic));
+  putUint64(record.data() + 4, ++sequence_);
+  putUint64(record.data() + 12, frames);
+  putUint64(record.data() + 20, dataBytes);
+  putUint64(record.data() + 28, timestampBytes);
+  putUint64(record.data() + 36,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch())
+                .count());
+  uint32_t sum = checksum(record);
+  for (size_t i = 0; i < 4; ++i) {
+    record[ChecksumOffset + i] =
+        static_cast<unsigned char>(sum >> (8 * (3 - i)));
+  }
+
+  off_t offset = static_cast<off_t>((sequence_ % SlotCount) * RecordSizeBytes);
+  if (::pwrite(fd_, record.data(), record.size(), offset) !=
+          static_cast<ssize_t>(record.size()) ||
+      ::fdatasync(fd_) != 0) {
+    throw std::runtime_error("Could not write journal " + path_ + ": " +
+                             std::strerror(errno));
+  }
+}
+
+std::string CaptureJournal::journalPath(const std::string &dataFileName) {
+  return dataFileName + ".journal";
+}
+
+std::optional<CaptureJournal::Commit>
+CaptureJournal::readLastCommit(const std::string &dataFileName) {
+  std::string path = journalPath(dataFileName);
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open journal " + path + ": " +
+                             std::strerror(errno));
+  }
+  std::optional<Commit> last;
+  for (size_t slot = 0; slot < SlotCount; ++slot) {
+    Record record{};
+    auto bytesRead = ::pread(fd, record.data(), record.size(),
+                             static_cast<off_t>(slot * RecordSizeBytes));
+    if (bytesRead != static_cast<ssize_t>(record.size())) {
+      continue;
+    }
+    auto commit = decode(record);
+    if (commit.has_value() &&
+        (!last.has_value() || commit->sequence > last->sequence)) {
+      last = commit;
+    }
+  }
+  ::close(fd);
+  return last;
+}
+
+CaptureJournal::Recovery
+CaptureJournal::recover(const std::string &dataFileName,
+                        const std::string &timestampFileName, bool dryRun) {
+  Recovery recovery;
+  recovery.commit = readLastCommit(dataFileName);
+  Commit commit = recovery.commit.value_or(Commit());
+  recovery.dataBytesFound =
+      truncateTo(dataFileName, commit.dataBytes, dryRun, recovery.truncated);
+  recovery.timestampBytesFound = truncateTo(
+      timestampFileName, commit.timestampBytes, dryRun, recovery.truncated);
+  return recovery;
+}
@@ -0,0 +1,49 @@
+#include "Codec.hpp"
+
+#include <stdexcept>
+
+#include <zlib.h>
+
+std::unique_ptr<ICodec> ICodec::fromName(const std::string &name) {
+  if (name == "none") {
+    return nullptr;
+  }
+  if (name == "lz4") {
+    return std::make_unique<Lz4Codec>();
+  }
+  if (name == "deflate") {
+    return std::make_unique<DeflateCodec>();
+  }
+  throw std::runtime_error("Unknown codec: " + name +
+                           " (expected none, lz4 or deflate)");
+}
+
+std::unique_ptr<ICodec> ICodec::fromId(uint8_t id) {
+  switch (id) {
+  case Lz4Codec::Id:
+    return std::make_unique<Lz4Codec>();
+  case DeflateCodec::Id:
+    return std::make_unique<DeflateCodec>();
+  default:
+    throw std::runtime_error("Unknown codec ID: " + std::to_string(id));
+  }
+}
+
+size_t DeflateCodec::compress(const char *source, size_t size,
+                              char *destination, size_t capacity) const {
+  uLongf compressedSize = capacity;
+  int result = compress2(reinterpret_cast<Bytef *>(destination),
+                         &compressedSize,
+                         reinterpret_cast<const Bytef *>(source), size,
+                         Z_BEST_SPEED);
+  return result == Z_OK ? compressedSize : 0;
+}
+
+bool DeflateCodec::decompress(const char *source, size_t size,
+                              char *destination, size_t originalSize) const {
+  uLongf decompressedSize = originalSize;
+  int result = uncompress(reinterpret_cast<Bytef *>(destination),
+                          &decompressedSize,
+                          reinterpret_cast<const Bytef *>(source), size);
+  return result == Z_OK && decompressedSize == originalSize;
+}
@@ -0,0 +1,150 @@
+#include "CompressionStage.hpp"
+#include "Codec.hpp"
+#include "Constants.hpp"
+#include "DataUnitConverter.hpp"
+#include "Trace.hpp"
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+
+double CompressionStage::Stats::ratio() const {
+  return outputBytes > 0 ? static_cast<double>(inputBytes) / outputBytes : 1.0;
+}
+
+double CompressionStage::Stats::throughputMBps() const {
+  double seconds = std::chrono::duration<double>(compressTime).count();
+  return seconds > 0 ? attemptedBytes / seconds / 1e6 : 0.0;
+}
+
+CompressionStage::CompressionStage(std::unique_ptr<IDataProvider> inner,
+                                   std::unique_ptr<ICodec> codec,
+                                   std::shared_ptr<WorkerPool> pool,
+                                   size_t lookahead)
+    : inner_(std::move(inner)), codec_(std::move(codec)),
+      pool_(std::move(pool)), lookahead_(std::max<size_t>(lookahead, 1)) {}
+
+CompressionStage::~CompressionStage() {
+  // Workers reference codec_, so wait for them before it is destroyed.
+  for (auto &result : pending_) {
+    result.wait();
+  }
+}
+
+std::optional<std::vector<char>> CompressionStage::getNextData() {
+  fill(lookahead_);
+  if (pending_.empty()) {
+    return std::nullopt;
+  }
+  Result result = pending_.front().get();
+  pending_.pop_front();
+  account(result);
+  // Keep the workers busy while the caller paces this frame.
+  fill(lookahead_);
+  return std::move(result.frame);
+}
+
+size_t CompressionStage::prefetch(size_t frames) {
+  fill(std::max(frames, lookahead_));
+  return pending_.size();
+}
+
+void CompressionStage::fill(size_t depth) {
+  while (!innerFinished_ && pending_.size() < depth) {
+    auto frame = inner_->getNextData();
+    if (!frame.has_value()) {
+      innerFinished_ = true;
+      break;
+    }
+
+    bool attempt = backoffRemaining_ == 0;
+    if (!attempt) {
+      --backoffRemaining_;
+    }
+    pending_.push_back(pool_->submit(
+        [codec = codec_.get(), attempt,
+         frame = std::move(frame.value())]() mutable {
+          VT_TRACE_SCOPE("compressFrame");
+          Result result;
+          result.inputSize = frame.size();
+          result.attempted = attempt;
+          if (attempt) {
+            auto start = std::chrono::steady_clock::now();
+            auto compressed = compressFrame(*codec, frame);
+            result.compressTime = std::chrono::steady_clock::now() - start;
+            if (compressed.has_value()) {
+              result.compressed = true;
+              frame = std::move(compressed.value());
+            }
+          }
+          result.frame = std::move(frame);
+          return result;
+        }));
+  }
+}
+
+void CompressionStage::account(const Result &result) {
+  ++stats_.frames;
+  stats_.inputBytes += result.inputSize;
+  stats_.outputBytes += result.frame.size();
+  if (!result.attempted) {
+    return;
+  }
+  ++stats_.attemptedFrames;
+  stats_.attemptedBytes += result.inputSize;
+  stats_.compressTime += result.compressTime;
+  if (result.compressed) {
+    ++stats_.compressedFrames;
+    poorFrames_ = 0;
+  } else if (++poorFrames_ >= PoorFramesBeforeBackoff) {
+    poorFrames_ = 0;
+    backoffRemaining_ = BackoffFrames;
+  }
+}
+
+std::optional<std::vector<char>>
+CompressionStage::compressFrame(const ICodec &codec,
+                                const std::vector<char> &frame) {
+  DataUnitConverter converter;
+  auto length = converter.decodeHeader(frame);
+  auto flags = converter.decodeFlags(frame.data(), frame.size());
+  if (!length.has_value() || (flags.value() & Constants::FlagCodecMask) ||
+      frame.size() != Constants::HeaderSizeBytes + length.value()) {
+    return std::nullopt;
+  }
+
+  size_t budget = static_cast<size_t>(length.value() * (1.0 - MinSavings));
+  if (budget <= Constants::OriginalLengthSizeBytes) {
+    return std::nullopt;
+  }
+  size_t capacity = budget - Constants::OriginalLengthSizeBytes;
+
+  // Leave room for the stream ID a multiplexed sender prepends.
+  std::vector<char> compressed;
+  compressed.reserve(Constants::StreamIdSizeBytes + Constants::HeaderSizeBytes +
+                     budget);
+  compressed.resize(Constants::HeaderSizeBytes +
+                    Constants::OriginalLengthSizeBytes + capacity);
+  char *payload = compressed.data() + Constants::HeaderSizeBytes +
+                  Constants::OriginalLengthSizeBytes;
+  size_t compressedSize =
+      codec.compress(frame.data() + Constants::HeaderSizeBytes,
+                     length.value(), payload, capacity);
+  if (compressedSize == 0) {
+    return std::nullopt;
+  }
+
+  uint32_t payloadLength = static_cast<uint32_t>(
+      Constants::OriginalLengthSizeBytes + compressedSize);
+  uint32_t header = payloadLength | (static_cast<uint32_t>(
+                                         flags.value() | codec.getId())
+                                     << Constants::HeaderFlagsShift);
+  for (int i = 0; i < Constants::HeaderSizeBytes; ++i) {
+    compressed[i] = static_cast<char>((header >> (8 * (3 - i))) & 0xFF);
+  }
+  for (int i = 0; i < Constants::OriginalLengthSizeBytes; ++i) {
+    compressed[Constants::HeaderSizeBytes + i] =
+        static_cast<char>((length.value() >> (8 * (3 - i))) & 0xFF);
+  }
+  compressed.resize(Constants::HeaderSizeBytes + payloadLength);
+  return compressed;
+}
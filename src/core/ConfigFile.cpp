@@ -0,0 +1,60 @@
+#include "ConfigFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+std::string trim(const std::string &text) {
+  auto first = text.find_first_not_of(" \t\r");
+  if (first == std::string::npos) {
+    return "";
+  }
+  auto last = text.find_last_not_of(" \t\r");
+  return text.substr(first, last - first + 1);
+}
+} // namespace
+
+std::vector<std::string> ConfigFile::load(const std::string &fileName) {
+  std::ifstream file(fileName);
+  if (!file) {
+    throw std::runtime_error("Could not open config file: " + fileName);
+  }
+
+  std::vector<std::string> arguments;
+  std::string line;
+  for (size_t lineNumber = 1; std::getline(file, line); ++lineNumber) {
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    auto equals = line.find('=');
+    std::string key = trim(line.substr(0, equals));
+    if (key.empty() || key.find_first_of(" \t") != std::string::npos) {
+      throw std::runtime_error(fileName + ":" + std::to_string(lineNumber) +
+                               ": expected <key> = <value>");
+    }
+    if (equals == std::string::npos) {
+      arguments.push_back("--" + key);
+    } else {
+      arguments.push_back("--" + key + "=" + trim(line.substr(equals + 1)));
+    }
+  }
+  return arguments;
+}
+
+std::vector<std::string> ConfigFile::expandArguments(int argc, char *argv[]) {
+  std::vector<std::string> fromFile;
+  std::vector<std::string> fromCommandLine;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--config=", 0) == 0) {
+      auto options = load(arg.substr(std::string("--config=").size()));
+      fromFile.insert(fromFile.end(), options.begin(), options.end());
+    } else {
+      fromCommandLine.push_back(arg);
+    }
+  }
+  fromFile.insert(fromFile.end(), fromCommandLine.begin(),
+                  fromCommandLine.end());
+  return fromFile;
+}
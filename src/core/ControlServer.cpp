@@ -0,0 +1,164 @@
+#include "ControlServer.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using boost::asio::local::stream_protocol;
+
+class ControlServer::Session
+    : public std::enable_shared_from_this<ControlServer::Session> {
+public:
+  Session(ControlServer &server, stream_protocol::socket socket)
+      : server_(server), socket_(std::move(socket)) {}
+
+  void readRequest() {
+    auto self = shared_from_this();
+    boost::asio::async_read_until(
+        socket_, request_, '\n',
+        [this, self](const boost::system::error_code &error, size_t) {
+          if (error) {
+            return; // client went away
+          }
+          std::istream stream(&request_);
+          std::string line;
+          std::getline(stream, line);
+          reply_ = server_.execute(line);
+          if (reply_.empty() || reply_.back() != '\n') {
+            reply_ += '\n';
+          }
+          reply_ += '\n';
+          writeReply();
+        });
+  }
+
+private:
+  void writeReply() {
+    auto self = shared_from_this();
+    boost::asio::async_write(
+        socket_, boost::asio::buffer(reply_),
+        [this, self](const boost::system::error_code &error, size_t) {
+          if (!error) {
+            readRequest();
+          }
+        });
+  }
+
+  ControlServer &server_;
+  stream_protocol::socket socket_;
+  boost::asio::streambuf request_;
+  std::string reply_;
+};
+
+ControlServer::ControlServer(std::string socketPath)
+    : socketPath_(std::move(socketPath)), acceptor_(ioContext_) {
+  addCommand("help", "help", [this](const std::vector<std::string> &) {
+    std::lock_guard<std::mutex> lock(commandsMutex_);
+    std::string usage;
+    for (const auto &command : commands_) {
+      usage += command.second.usage + "\n";
+    }
+    return usage;
+  });
+}
+
+ControlServer::~ControlServer() { stop(); }
+
+void ControlServer::addCommand(const std::string &name,
+                               const std::string &usage, Handler handler) {
+  std::lock_guard<std::mutex> lock(commandsMutex_);
+  commands_[name] = Command{usage, std::move(handler)};
+}
+
+void ControlServer::start() {
+  // Only a socket left behind by an earlier run is replaced; one that still
+  // accepts connections belongs to a running process.
+  stream_protocol::endpoint endpoint(socketPath_);
+  struct stat status {};
+  if (::lstat(socketPath_.c_str(), &status) == 0) {
+    if (!S_ISSOCK(status.st_mode)) {
+      throw std::runtime_error("Control socket path exists and is not a "
+                               "socket: " + socketPath_);
+    }
+    stream_protocol::socket probe(ioContext_);
+    boost::system::error_code probeError;
+    probe.connect(endpoint, probeError);
+    if (!probeError) {
+      throw std::runtime_error("Control socket in use: " + socketPath_);
+    }
+    if (probeError != boost::asio::error::connection_refused) {
+      throw std::runtime_error("Could not check control socket " +
+                               socketPath_ + ": " + probeError.message());
+    }
+    if (::unlink(socketPath_.c_str()) != 0) {
+      throw std::runtime_error("Could not remove stale control socket " +
+                               socketPath_ + ": " + std::strerror(errno));
+    }
+  }
+  acceptor_.open(endpoint.protocol());
+  acceptor_.bind(endpoint);
+  acceptor_.listen();
+  accept();
+  ioContext_.restart();
+  thread_ = std::thread([this]() { ioContext_.run(); });
+}
+
+void ControlServer::stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  ioContext_.stop();
+  thread_.join();
+  boost::system::error_code ignored;
+  acceptor_.close(ignored);
+  ::unlink(socketPath_.c_str());
+}
+
+std::string ControlServer::execute(const std::string &line) {
+  std::istringstream words(line);
+  std::string name;
+  words >> name;
+  std::vector<std::string> args;
+  for (std::string arg; words >> arg;) {
+    args.push_back(arg);
+  }
+  if (name.empty()) {
+    return "error: empty command";
+  }
+
+  Handler handler;
+  {
+    std::lock_guard<std::mutex> lock(commandsMutex_);
+    auto command = commands_.find(name);
+    if (command == commands_.end()) {
+      return "error: unknown command " + name + " (try help)";
+    }
+    handler = command->second.handler;
+  }
+  try {
+    return handler(args);
+  } catch (const std::exception &e) {
+    return "error: " + std::string(e.what());
+  }
+}
+
+void ControlServer::accept() {
+  acceptor_.async_accept([this](const boost::system::error_code &error,
+                                stream_protocol::socket socket) {
+    if (error) {
+      if (error != boost::asio::error::operation_aborted) {
+        std::cerr << "Control socket accept failed: " << error.message()
+                  << std::endl;
+      }
+      return;
+    }
+    std::make_shared<Session>(*this, std::move(socket))->readRequest();
+    accept();
+  });
+}
@@ -0,0 +1,88 @@
+#include "CutThroughAcceptor.hpp"
+#include "DataUnitConverter.hpp"
+#include "FrameSink.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+double CutThroughAcceptor::Stats::chunksPerFrame() const {
+  return frames == 0 ? 0.0 : static_cast<double>(chunks) / frames;
+}
+
+std::chrono::microseconds CutThroughAcceptor::Stats::averageLeadTime() const {
+  return frames == 0 ? std::chrono::microseconds(0)
+                     : leadTime / static_cast<int64_t>(frames);
+}
+
+CutThroughAcceptor::CutThroughAcceptor(std::unique_ptr<IFrameSink> sink)
+    : sink_(std::move(sink)),
+      converter_(std::make_unique<DataUnitConverter>()) {}
+
+CutThroughAcceptor::~CutThroughAcceptor() = default;
+
+void CutThroughAcceptor::processRawData(const std::vector<char> &rawData) {
+  processRawData(rawData.data(), rawData.size(),
+                 std::chrono::system_clock::now());
+}
+
+void CutThroughAcceptor::processRawData(
+    const std::vector<char> &rawData,
+    std::chrono::system_clock::time_point arrivalTime) {
+  processRawData(rawData.data(), rawData.size(), arrivalTime);
+}
+
+void CutThroughAcceptor::processRawData(
+    const char *data, size_t size,
+    std::chrono::system_clock::time_point arrivalTime) {
+  VT_TRACE_SCOPE("CutThroughAcceptor::processRawData");
+  totalBytesReceived_ += size;
+
+  size_t offset = 0;
+  while (offset < size) {
+    if (!inFrame_) {
+      // The header may itself be split across reads.
+      size_t take =
+          std::min(Constants::HeaderSizeBytes - headerBytes_, size - offset);
+      std::memcpy(header_.data() + headerBytes_, data + offset, take);
+      headerBytes_ += take;
+      offset += take;
+      if (headerBytes_ < Constants::HeaderSizeBytes) {
+        return;
+      }
+      headerBytes_ = 0;
+
+      remaining_ =
+          converter_->decodeHeader(header_.data(), header_.size()).value();
+      uint8_t flags =
+          converter_->decodeFlags(header_.data(), header_.size()).value();
+      sink_->beginFrame(remaining_, flags, arrivalTime);
+      frameBeganAt_ = arrivalTime;
+      inFrame_ = true;
+    }
+
+    size_t take = std::min<size_t>(remaining_, size - offset);
+    if (take > 0) {
+      sink_->frameChunk(data + offset, take);
+      stats_.chunks++;
+      offset += take;
+      remaining_ -= static_cast<uint32_t>(take);
+    }
+    if (remaining_ == 0) {
+      sink_->endFrame(arrivalTime);
+      inFrame_ = false;
+      stats_.frames++;
+      stats_.leadTime += std::chrono::duration_cast<std::chrono::microseconds>(
+          arrivalTime - frameBeganAt_);
+      dataUnitsReceived_++;
+    }
+  }
+}
+
+size_t CutThroughAcceptor::getDataUnitsReceived() const {
+  return dataUnitsReceived_;
+}
+
+size_t CutThroughAcceptor::getTotalBytesReceived() const {
+  return totalBytesReceived_;
+}
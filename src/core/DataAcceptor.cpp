@@ -5,6 +5,10 @@
 #include <chrono>
 #include <stdexcept>
 #include "DataUnitConverter.hpp"
+#include "Codec.hpp"
+#include "FrameCipher.hpp"
+#include "Constants.hpp"
+#include "Trace.hpp"
 
 DataAcceptor::DataAcceptor(std::unique_ptr<IDataFile> videoDataWriter,
                            std::unique_ptr<ITimestampWriter> timestampWriter)
@@ -12,19 +16,46 @@ DataAcceptor::DataAcceptor(std::unique_ptr<IDataFile> videoDataWriter,
       timestampWriter_(std::move(timestampWriter)),
       converter_(std::make_unique<DataUnitConverter>()) {}
 
+DataAcceptor::~DataAcceptor() = default;
+
 void DataAcceptor::processRawData(const std::vector<char> &rawData) {
+  acceptRawData(rawData, std::nullopt);
+}
+
+void DataAcceptor::processRawData(
+    const std::vector<char> &rawData,
+    std::chrono::system_clock::time_point arrivalTime) {
+  acceptRawData(rawData, arrivalTime);
+}
+
+void DataAcceptor::acceptRawData(
+    const std::vector<char> &rawData,
+    std::optional<std::chrono::system_clock::time_point> arrivalTime) {
+  VT_TRACE_SCOPE("processRawData");
   totalBytesReceived_ += rawData.size();
 
+  // One read may complete several units; drain all of them.
   auto dataUnit = converter_->decodeDataUnit(rawData);
-  if (!dataUnit.has_value()) {
-    return;
-  }
+  while (dataUnit.has_value()) {
+    rotation_.apply(videoDataWriter_, timestampWriter_);
+    if (cipher_ || (dataUnit->flags & Constants::FlagEncrypted)) {
+      decrypt(dataUnit.value());
+    }
+    if (dataUnit->flags & Constants::FlagCodecMask) {
+      decompress(dataUnit.value());
+    }
+    std::vector<char> binaryData = converter_->encodeDataUnit(dataUnit.value());
+    videoDataWriter_->writeBinaryData(binaryData);
 
-  std::vector<char> binaryData = converter_->encodeDataUnit(dataUnit.value());
-  videoDataWriter_->writeBinaryData(binaryData);
+    if (arrivalTime.has_value()) {
+      timestampWriter_->write(dataUnit.value(), arrivalTime.value());
+    } else {
+      timestampWriter_->write(dataUnit.value());
+    }
+    dataUnitsReceived_++;
 
-  timestampWriter_->write(dataUnit.value());
-  dataUnitsReceived_++;
+    dataUnit = converter_->decodeDataUnit({});
+  }
 }
 
 size_t DataAcceptor::getDataUnitsReceived() const { return dataUnitsReceived_; }
@@ -32,3 +63,68 @@ size_t DataAcceptor::getDataUnitsReceived() const { return dataUnitsReceived_; }
 size_t DataAcceptor::getTotalBytesReceived() const {
   return totalBytesReceived_;
 }
+
+size_t DataAcceptor::getCompressedUnitsReceived() const {
+  return compressedUnitsReceived_;
+}
+
+size_t DataAcceptor::getEncryptedUnitsReceived() const {
+  return encryptedUnitsReceived_;
+}
+
+void DataAcceptor::setCipher(std::unique_ptr<FrameCipher> cipher) {
+  cipher_ = std::move(cipher);
+}
+
+void DataAcceptor::rotate(std::unique_ptr<IDataFile> videoDataWriter,
+                          std::unique_ptr<ITimestampWriter> timestampWriter) {
+  rotation_.request(std::move(videoDataWriter), std::move(timestampWriter));
+}
+
+void DataAcceptor::decrypt(DataUnit &unit) {
+  VT_TRACE_SCOPE("decrypt");
+  if (!cipher_) {
+    throw std::runtime_error("Encrypted data unit received without a key");
+  }
+  if (!(unit.flags & Constants::FlagEncrypted)) {
+    throw std::runtime_error("Unencrypted data unit rejected");
+  }
+  if (!cipher_->open(unit)) {
+    throw std::runtime_error("Data unit failed authentication");
+  }
+  encryptedUnitsReceived_++;
+}
+
+void DataAcceptor::decompress(DataUnit &unit) {
+  VT_TRACE_SCOPE("decompress");
+  uint8_t codecId = unit.flags & Constants::FlagCodecMask;
+  auto &codec = codecs_[codecId];
+  if (!codec) {
+    codec = ICodec::fromId(codecId);
+  }
+
+  if (unit.data.size() < Constants::OriginalLengthSizeBytes) {
+    throw std::runtime_error("Compressed data unit is too short");
+  }
+  uint32_t originalLength = 0;
+  for (int i = 0; i < Constants::OriginalLengthSizeBytes; ++i) {
+    originalLength = (originalLength << 8) |
+                     static_cast<unsigned char>(unit.data[i]);
+  }
+  if (originalLength > Constants::MaxPacketSize - Constants::HeaderSizeBytes) {
+    throw std::runtime_error("Compressed data unit declares oversized length " +
+                             std::to_string(originalLength));
+  }
+
+  std::vector<char> original(originalLength);
+  if (!codec->decompress(unit.data.data() + Constants::OriginalLengthSizeBytes,
+                         unit.data.size() - Constants::OriginalLengthSizeBytes,
+                         original.data(), originalLength)) {
+    throw std::runtime_error(std::string("Corrupt ") + codec->getName() +
+                             " data unit");
+  }
+  unit.data = std::move(original);
+  unit.length = originalLength;
+  unit.flags &= ~Constants::FlagCodecMask;
+  compressedUnitsReceived_++;
+}
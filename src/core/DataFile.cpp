@@ -1,13 +1,20 @@
 #include "DataFile.hpp"
 #include "DataUnitConverter.hpp"
 #include "Constants.hpp"
+#include "Trace.hpp"
 
 #include <fstream>
 #include <stdexcept>
 #include <iostream>
+#include <cerrno>
+#include <cstring>
 
-DataFile::DataFile(const std::string &filename, Mode mode)
-    : filename_(filename), mode_(mode) {
+#include <fcntl.h>
+#include <unistd.h>
+
+DataFile::DataFile(const std::string &filename, Mode mode,
+                   Durability durability)
+    : filename_(filename), mode_(mode), durability_(durability) {
   if (mode == Mode::Read) {
     file_.open(filename, std::ios::binary | std::ios::in);
     if (!file_.is_open()) {
@@ -18,13 +25,39 @@ DataFile::DataFile(const std::string &filename, Mode mode)
     if (!file_.is_open()) {
       throw std::runtime_error("Could not open file for writing: " + filename);
     }
+    if (durability_ == Durability::Sync) {
+      // fstream hides its descriptor; a second one syncs the same file.
+      syncFd_ = ::open(filename.c_str(), O_WRONLY);
+      if (syncFd_ < 0) {
+        throw std::runtime_error("Could not open file for syncing: " +
+                                 filename + ": " + std::strerror(errno));
+      }
+    }
     std::cout << "Output file opened: " + filename << std::endl;
   }
 }
 
+DataFile::Durability DataFile::durabilityFromName(const std::string &name) {
+  if (name == "buffered") {
+    return Durability::Buffered;
+  }
+  if (name == "flush") {
+    return Durability::Flush;
+  }
+  if (name == "sync") {
+    return Durability::Sync;
+  }
+  throw std::runtime_error("Unknown durability: " + name +
+                           " (expected buffered, flush or sync)");
+}
+
 DataFile::~DataFile() {
   if (file_.is_open()) {
     file_.close();
+    if (syncFd_ >= 0) {
+      ::fdatasync(syncFd_);
+      ::close(syncFd_);
+    }
     if (mode_ == Mode::Write) {
       std::cout << "Output file closed. Total bytes written: " +
                        std::to_string(bytesWritten_)
@@ -34,14 +67,28 @@ DataFile::~DataFile() {
 }
 
 void DataFile::writeBinaryData(const std::vector<char> &data) {
+  VT_TRACE_SCOPE("writeBinaryData");
+  writePartialData(data.data(), data.size());
+  finishDataUnit();
+}
+
+void DataFile::writePartialData(const char *data, size_t size) {
   if (!file_.is_open()) {
     throw std::runtime_error("File is not open");
   }
 
-  file_.write(data.data(), data.size());
-  bytesWritten_ += data.size();
+  file_.write(data, size);
+  bytesWritten_ += size;
+}
 
-  file_.flush();
+void DataFile::finishDataUnit() {
+  if (durability_ != Durability::Buffered) {
+    file_.flush();
+  }
+  if (syncFd_ >= 0 && ::fdatasync(syncFd_) != 0) {
+    throw std::runtime_error("Could not sync " + filename_ + ": " +
+                             std::strerror(errno));
+  }
 }
 
 std::optional<std::vector<char>> DataFile::readNextDataUnit() {
@@ -11,6 +11,26 @@ DataProvider::DataProvider(std::unique_ptr<IDataFile> dataFile)
       converter_(std::make_unique<DataUnitConverter>()) {}
 
 std::optional<std::vector<char>> DataProvider::getNextData() {
+  if (!prefetched_.empty()) {
+    auto dataUnit = std::move(prefetched_.front());
+    prefetched_.pop_front();
+    return dataUnit;
+  }
+  return readNextData();
+}
+
+size_t DataProvider::prefetch(size_t frames) {
+  while (prefetched_.size() < frames) {
+    auto dataUnit = readNextData();
+    if (!dataUnit.has_value()) {
+      break;
+    }
+    prefetched_.push_back(std::move(dataUnit.value()));
+  }
+  return prefetched_.size();
+}
+
+std::optional<std::vector<char>> DataProvider::readNextData() {
   auto binaryDataUnit = dataFile_->readNextDataUnit();
   if (!binaryDataUnit.has_value()) {
     return std::nullopt; // No more data units
@@ -1,14 +1,20 @@
 #include "DataUnitConverter.hpp"
 #include "Constants.hpp"
+#include "FrameCipher.hpp"
+#include "Trace.hpp"
 #include <iostream>
 #include <stdexcept>
+#include <string>
 #include <cstdint>
 
 std::vector<char> DataUnitConverter::encodeDataUnit(const DataUnit &unit) {
+  VT_TRACE_SCOPE("encodeDataUnit");
   std::vector<char> encodedData;
   encodedData.reserve(Constants::HeaderSizeBytes + unit.length);
 
-  uint32_t length = unit.length;
+  uint32_t length = (unit.length & Constants::HeaderLengthMask) |
+                    (static_cast<uint32_t>(unit.flags)
+                     << Constants::HeaderFlagsShift);
   for (int i = Constants::HeaderSizeBytes - 1; i >= 0; --i) {
     encodedData.push_back(static_cast<char>((length >> (8 * i)) & 0xFF));
   }
@@ -20,6 +26,7 @@ std::vector<char> DataUnitConverter::encodeDataUnit(const DataUnit &unit) {
 
 std::optional<DataUnit>
 DataUnitConverter::decodeDataUnit(const std::vector<char> &data) {
+  VT_TRACE_SCOPE("decodeDataUnit");
   buffer_.insert(buffer_.end(), data.begin(), data.end());
 
   while (buffer_.size() >= Constants::HeaderSizeBytes) {
@@ -27,6 +34,7 @@ DataUnitConverter::decodeDataUnit(const std::vector<char> &data) {
     if (!length.has_value()) {
       return std::nullopt;
     }
+    validateHeader(buffer_.data(), buffer_.size());
 
     size_t totalDataUnitSize = Constants::HeaderSizeBytes + length.value();
     if (buffer_.size() < totalDataUnitSize) {
@@ -35,6 +43,7 @@ DataUnitConverter::decodeDataUnit(const std::vector<char> &data) {
 
     DataUnit unit;
     unit.length = length.value();
+    unit.flags = decodeFlags(buffer_.data(), buffer_.size()).value();
     unit.data.assign(buffer_.begin() + Constants::HeaderSizeBytes,
                      buffer_.begin() + Constants::HeaderSizeBytes +
                          length.value());
@@ -49,7 +58,12 @@ DataUnitConverter::decodeDataUnit(const std::vector<char> &data) {
 
 std::optional<uint32_t>
 DataUnitConverter::decodeHeader(const std::vector<char> &data) {
-  if (data.size() < Constants::HeaderSizeBytes) {
+  return decodeHeader(data.data(), data.size());
+}
+
+std::optional<uint32_t> DataUnitConverter::decodeHeader(const char *data,
+                                                        size_t size) {
+  if (size < Constants::HeaderSizeBytes) {
     return std::nullopt;
   }
 
@@ -59,5 +73,29 @@ DataUnitConverter::decodeHeader(const std::vector<char> &data) {
               << (8 * (3 - i));
   }
 
-  return length;
-}
\ No newline at end of file
+  return length & Constants::HeaderLengthMask;
+}
+
+std::optional<uint8_t> DataUnitConverter::decodeFlags(const char *data,
+                                                      size_t size) {
+  if (size < Constants::HeaderSizeBytes) {
+    return std::nullopt;
+  }
+  return static_cast<uint8_t>(data[0]);
+}
+
+void DataUnitConverter::validateHeader(const char *data, size_t size) {
+  auto length = decodeHeader(data, size);
+  if (!length.has_value()) {
+    return;
+  }
+  uint8_t flags = decodeFlags(data, size).value();
+  if (flags & Constants::FlagReservedMask) {
+    throw std::runtime_error("Data unit has reserved flags set: " +
+                             std::to_string(flags));
+  }
+  if (length.value() > Constants::MaxPacketSize + FrameCipher::OverheadBytes) {
+    throw std::runtime_error("Data unit length out of range: " +
+                             std::to_string(length.value()));
+  }
+}
@@ -0,0 +1,41 @@
+#include "EncryptionStage.hpp"
+#include "FrameCipher.hpp"
+
+double EncryptionStage::Stats::throughputMBps() const {
+  double seconds = std::chrono::duration<double>(sealTime).count();
+  return seconds > 0 ? plainBytes / seconds / 1e6 : 0.0;
+}
+
+double EncryptionStage::Stats::microsecondsPerFrame() const {
+  return frames > 0
+             ? std::chrono::duration<double, std::micro>(sealTime).count() /
+                   frames
+             : 0.0;
+}
+
+EncryptionStage::EncryptionStage(std::unique_ptr<IDataProvider> inner,
+                                 std::unique_ptr<FrameCipher> cipher)
+    : inner_(std::move(inner)), cipher_(std::move(cipher)) {}
+
+EncryptionStage::~EncryptionStage() = default;
+
+std::optional<std::vector<char>> EncryptionStage::getNextData() {
+  auto frame = inner_->getNextData();
+  if (!frame.has_value()) {
+    return std::nullopt;
+  }
+  size_t plainSize = frame->size();
+  auto start = std::chrono::steady_clock::now();
+  cipher_->seal(frame.value());
+  stats_.sealTime += std::chrono::steady_clock::now() - start;
+  ++stats_.frames;
+  stats_.plainBytes += plainSize;
+  stats_.overheadBytes += frame->size() - plainSize;
+  return frame;
+}
+
+size_t EncryptionStage::prefetch(size_t frames) {
+  // Sealing is cheap next to reading and compression, so it stays on
+  // hand-out.
+  return inner_->prefetch(frames);
+}
@@ -0,0 +1,227 @@
+#include "FrameCipher.hpp"
+#include "Constants.hpp"
+#include "DataUnit.hpp"
+#include "DataUnitConverter.hpp"
+#include "Trace.hpp"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+// Header | stream ID | nonce counter.
+constexpr size_t AssociatedDataBytes =
+    Constants::HeaderSizeBytes + Constants::StreamIdSizeBytes + 4;
+
+void writeHeader(unsigned char *out, uint32_t length, uint8_t flags) {
+  uint32_t header = (length & Constants::HeaderLengthMask) |
+                    (static_cast<uint32_t>(flags) << Constants::HeaderFlagsShift);
+  for (int i = 0; i < Constants::HeaderSizeBytes; ++i) {
+    out[i] = static_cast<unsigned char>((header >> (8 * (3 - i))) & 0xFF);
+  }
+}
+
+uint32_t nonceCounter(const unsigned char *nonce) {
+  uint32_t counter = 0;
+  for (size_t i = sizeof(uint64_t); i < FrameCipher::NonceSizeBytes; ++i) {
+    counter = (counter << 8) | nonce[i];
+  }
+  return counter;
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+} // namespace
+
+FrameCipher::FrameCipher(const Key &key, uint16_t streamId)
+    : encryptContext_(EVP_CIPHER_CTX_new()),
+      decryptContext_(EVP_CIPHER_CTX_new()), streamId_(streamId) {
+  if (!encryptContext_ || !decryptContext_ ||
+      EVP_EncryptInit_ex(encryptContext_, EVP_aes_256_gcm(), nullptr,
+                         key.data(), nullptr) != 1 ||
+      EVP_DecryptInit_ex(decryptContext_, EVP_aes_256_gcm(), nullptr,
+                         key.data(), nullptr) != 1 ||
+      RAND_bytes(reinterpret_cast<unsigned char *>(&salt_), sizeof(salt_)) !=
+          1) {
+    EVP_CIPHER_CTX_free(encryptContext_);
+    EVP_CIPHER_CTX_free(decryptContext_);
+    throw std::runtime_error("Failed to initialise AES-256-GCM");
+  }
+}
+
+FrameCipher::~FrameCipher() {
+  EVP_CIPHER_CTX_free(encryptContext_);
+  EVP_CIPHER_CTX_free(decryptContext_);
+}
+
+FrameCipher::Key FrameCipher::loadKey(const std::string &fileName) {
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Failed to open key file: " + fileName);
+  }
+  std::string contents((std::istreambuf_iterator<char>(file)),
+                       std::istreambuf_iterator<char>());
+
+  Key key;
+  if (contents.size() == KeySizeBytes) {
+    std::memcpy(key.data(), contents.data(), KeySizeBytes);
+    return key;
+  }
+  while (!contents.empty() &&
+         (contents.back() == '\n' || contents.back() == '\r')) {
+    contents.pop_back();
+  }
+  if (contents.size() != 2 * KeySizeBytes) {
+    throw std::runtime_error("Key file must hold 32 raw bytes or 64 hex "
+                             "digits: " + fileName);
+  }
+  for (size_t i = 0; i < KeySizeBytes; ++i) {
+    int high = hexValue(contents[2 * i]);
+    int low = hexValue(contents[2 * i + 1]);
+    if (high < 0 || low < 0) {
+      throw std::runtime_error("Invalid hex digit in key file: " + fileName);
+    }
+    key[i] = static_cast<unsigned char>(high << 4 | low);
+  }
+  return key;
+}
+
+bool FrameCipher::hardwareAccelerated() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul");
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void FrameCipher::seal(std::vector<char> &frame) {
+  VT_TRACE_SCOPE("sealFrame");
+  DataUnitConverter converter;
+  auto length = converter.decodeHeader(frame);
+  auto flags = converter.decodeFlags(frame.data(), frame.size());
+  if (!length.has_value() ||
+      frame.size() != Constants::HeaderSizeBytes + length.value()) {
+    throw std::runtime_error("Cannot encrypt a malformed data unit");
+  }
+  if (flags.value() & Constants::FlagEncrypted) {
+    return;
+  }
+  size_t sealedLength = length.value() + OverheadBytes;
+  if (sealedLength > Constants::HeaderLengthMask) {
+    throw std::runtime_error("Data unit too large to encrypt");
+  }
+
+  // The nonce and tag follow the ciphertext, so the payload is encrypted
+  // where it is and sealing only appends. Leave room for the stream ID a
+  // multiplexed sender prepends.
+  frame.reserve(Constants::StreamIdSizeBytes + Constants::HeaderSizeBytes +
+                sealedLength);
+  frame.resize(Constants::HeaderSizeBytes + sealedLength);
+  auto *header = reinterpret_cast<unsigned char *>(frame.data());
+  unsigned char *payload = header + Constants::HeaderSizeBytes;
+  unsigned char *nonce = payload + length.value();
+  nextNonce(nonce);
+  writeHeader(header, static_cast<uint32_t>(sealedLength),
+              flags.value() | Constants::FlagEncrypted);
+  unsigned char associatedData[AssociatedDataBytes];
+  writeAssociatedData(associatedData, static_cast<uint32_t>(sealedLength),
+                      flags.value() | Constants::FlagEncrypted, nonce);
+
+  int outLength = 0;
+  if (EVP_EncryptInit_ex(encryptContext_, nullptr, nullptr, nullptr, nonce) !=
+          1 ||
+      EVP_EncryptUpdate(encryptContext_, nullptr, &outLength, associatedData,
+                        AssociatedDataBytes) != 1 ||
+      EVP_EncryptUpdate(encryptContext_, payload, &outLength, payload,
+                        static_cast<int>(length.value())) != 1 ||
+      EVP_EncryptFinal_ex(encryptContext_, payload + outLength, &outLength) !=
+          1 ||
+      EVP_CIPHER_CTX_ctrl(encryptContext_, EVP_CTRL_GCM_GET_TAG, TagSizeBytes,
+                          nonce + NonceSizeBytes) != 1) {
+    throw std::runtime_error("AES-256-GCM encryption failed");
+  }
+}
+
+bool FrameCipher::open(DataUnit &unit) {
+  VT_TRACE_SCOPE("openFrame");
+  if (!(unit.flags & Constants::FlagEncrypted) ||
+      unit.data.size() < OverheadBytes || unit.data.size() != unit.length) {
+    return false;
+  }
+  auto *payload = reinterpret_cast<unsigned char *>(unit.data.data());
+  size_t payloadLength = unit.data.size() - OverheadBytes;
+  unsigned char *nonce = payload + payloadLength;
+  uint64_t salt = 0;
+  std::memcpy(&salt, nonce, sizeof(salt));
+  uint32_t counter = nonceCounter(nonce);
+  if (openedSalt_.has_value() &&
+      (salt != openedSalt_.value() || counter <= openedCounter_)) {
+    return false; // another session, replayed or reordered
+  }
+  unsigned char associatedData[AssociatedDataBytes];
+  writeAssociatedData(associatedData, unit.length, unit.flags, nonce);
+
+  int outLength = 0;
+  if (EVP_DecryptInit_ex(decryptContext_, nullptr, nullptr, nullptr, nonce) !=
+          1 ||
+      EVP_DecryptUpdate(decryptContext_, nullptr, &outLength, associatedData,
+                        AssociatedDataBytes) != 1 ||
+      EVP_DecryptUpdate(decryptContext_, payload, &outLength, payload,
+                        static_cast<int>(payloadLength)) != 1 ||
+      EVP_CIPHER_CTX_ctrl(decryptContext_, EVP_CTRL_GCM_SET_TAG, TagSizeBytes,
+                          nonce + NonceSizeBytes) != 1 ||
+      EVP_DecryptFinal_ex(decryptContext_, payload + outLength, &outLength) !=
+          1) {
+    return false;
+  }
+  // Only authenticated frames pin the salt and advance the counter, so
+  // forgeries cannot hijack or block the stream.
+  openedSalt_ = salt;
+  openedCounter_ = counter;
+
+  unit.data.resize(payloadLength);
+  unit.length = static_cast<uint32_t>(payloadLength);
+  unit.flags &= ~Constants::FlagEncrypted;
+  return true;
+}
+
+void FrameCipher::nextNonce(unsigned char *nonce) {
+  // The receiver is pinned to this salt, so a wrapped counter cannot be
+  // re-salted; the stream needs a new key or a new session.
+  if (counter_ == std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("AES-GCM nonce counter exhausted; rekey needed");
+  }
+  ++counter_;
+  std::memcpy(nonce, &salt_, sizeof(salt_));
+  for (size_t i = 0; i < sizeof(counter_); ++i) {
+    nonce[sizeof(salt_) + i] =
+        static_cast<unsigned char>((counter_ >> (8 * (3 - i))) & 0xFF);
+  }
+}
+
+void FrameCipher::writeAssociatedData(unsigned char *out, uint32_t length,
+                                      uint8_t flags,
+                                      const unsigned char *nonce) const {
+  writeHeader(out, length, flags);
+  out += Constants::HeaderSizeBytes;
+  out[0] = static_cast<unsigned char>(streamId_ >> 8);
+  out[1] = static_cast<unsigned char>(streamId_ & 0xFF);
+  std::memcpy(out + Constants::StreamIdSizeBytes, nonce + sizeof(salt_), 4);
+}
@@ -0,0 +1,132 @@
+#include "FrameIndex.hpp"
+#include "Constants.hpp"
+#include "MappedFile.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+constexpr char IndexMagic[8] = {'V', 'T', 'I', 'D', 'X', '0', '0', '1'};
+constexpr uint64_t IndexHeaderBytes =
+    sizeof(IndexMagic) + sizeof(uint64_t) + sizeof(int64_t) + sizeof(uint64_t);
+constexpr uint64_t IndexEntryBytes =
+    sizeof(CaptureAnalyzer::FrameIndexEntry::offset) +
+    sizeof(CaptureAnalyzer::FrameIndexEntry::length);
+
+int64_t modificationTime(const std::string &filename) {
+  return static_cast<int64_t>(std::filesystem::last_write_time(filename)
+                                  .time_since_epoch()
+                                  .count());
+}
+
+template <typename T> void writeField(std::ostream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T> bool readField(std::istream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+} // namespace
+
+FrameIndex FrameIndex::build(const std::string &filename,
+                             const MappedFile &file) {
+  auto framing = CaptureAnalyzer(1).indexFrames(file.data(), file.size());
+  if (!framing.error.empty()) {
+    throw std::runtime_error("Invalid framing in " + filename + ": " +
+                             framing.error);
+  }
+
+  FrameIndex index;
+  index.frames_ = std::move(framing.frames);
+  index.fileSize_ = file.size();
+  index.modificationTime_ = modificationTime(filename);
+  return index;
+}
+
+std::optional<FrameIndex> FrameIndex::load(const std::string &filename,
+                                           const MappedFile &file) {
+  std::string path = indexPath(filename);
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    return std::nullopt;
+  }
+
+  char magic[sizeof(IndexMagic)];
+  FrameIndex index;
+  uint64_t frameCount = 0;
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, IndexMagic, sizeof(magic)) != 0 ||
+      !readField(in, index.fileSize_) ||
+      !readField(in, index.modificationTime_) || !readField(in, frameCount)) {
+    return std::nullopt;
+  }
+  if (index.fileSize_ != file.size() ||
+      index.fileSize_ != std::filesystem::file_size(filename) ||
+      index.modificationTime_ != modificationTime(filename)) {
+    return std::nullopt; // recording changed since the index was written
+  }
+  // The count must match the index size before anything is allocated.
+  uint64_t indexSize = std::filesystem::file_size(path);
+  if (indexSize < IndexHeaderBytes ||
+      frameCount != (indexSize - IndexHeaderBytes) / IndexEntryBytes ||
+      indexSize != IndexHeaderBytes + frameCount * IndexEntryBytes) {
+    return std::nullopt;
+  }
+
+  // Frames follow each other without gaps up to the end of the recording.
+  index.frames_.resize(frameCount);
+  uint64_t nextOffset = 0;
+  for (auto &entry : index.frames_) {
+    if (!readField(in, entry.offset) || !readField(in, entry.length) ||
+        entry.offset != nextOffset ||
+        entry.length > file.size() - entry.offset ||
+        file.size() - entry.offset - entry.length <
+            Constants::HeaderSizeBytes) {
+      return std::nullopt;
+    }
+    nextOffset = entry.offset + Constants::HeaderSizeBytes + entry.length;
+  }
+  if (nextOffset != file.size()) {
+    return std::nullopt;
+  }
+  index.loaded_ = true;
+  return index;
+}
+
+FrameIndex FrameIndex::loadOrBuild(const std::string &filename,
+                                   const MappedFile &file) {
+  if (auto index = load(filename, file)) {
+    return std::move(index.value());
+  }
+  auto index = build(filename, file);
+  if (!index.save(filename)) {
+    std::cerr << "Warning: could not write frame index " + indexPath(filename)
+              << std::endl;
+  }
+  return index;
+}
+
+std::string FrameIndex::indexPath(const std::string &filename) {
+  return filename + ".idx";
+}
+
+bool FrameIndex::save(const std::string &filename) const {
+  std::ofstream out(indexPath(filename), std::ios::binary | std::ios::trunc);
+  if (!out.is_open()) {
+    return false;
+  }
+  // Native byte order: the index is a local cache, not an exchange format.
+  out.write(IndexMagic, sizeof(IndexMagic));
+  writeField(out, fileSize_);
+  writeField(out, modificationTime_);
+  writeField(out, static_cast<uint64_t>(frames_.size()));
+  for (const auto &entry : frames_) {
+    writeField(out, entry.offset);
+    writeField(out, entry.length);
+  }
+  return static_cast<bool>(out.flush());
+}
@@ -0,0 +1,75 @@
+#include "FrameSink.hpp"
+#include "Constants.hpp"
+#include "DataFile.hpp"
+#include "TimestampWriter.hpp"
+#include "Trace.hpp"
+
+#include <stdexcept>
+
+FileFrameSink::FileFrameSink(std::unique_ptr<IDataFile> videoDataWriter,
+                             std::unique_ptr<ITimestampWriter> timestampWriter)
+    : videoDataWriter_(std::move(videoDataWriter)),
+      timestampWriter_(std::move(timestampWriter)) {}
+
+FileFrameSink::~FileFrameSink() = default;
+
+void FileFrameSink::beginFrame(
+    uint32_t length, uint8_t flags,
+    std::chrono::system_clock::time_point /*arrivalTime*/) {
+  VT_TRACE_SCOPE("FileFrameSink::beginFrame");
+  if (flags & (Constants::FlagEncrypted | Constants::FlagCodecMask)) {
+    throw std::runtime_error(
+        "Cut-through cannot write compressed or encrypted data units");
+  }
+  rotation_.apply(videoDataWriter_, timestampWriter_);
+
+  unit_.length = length;
+  unit_.flags = flags;
+  uint32_t header =
+      (length & Constants::HeaderLengthMask) |
+      (static_cast<uint32_t>(flags) << Constants::HeaderFlagsShift);
+  char bytes[Constants::HeaderSizeBytes];
+  for (int i = 0; i < Constants::HeaderSizeBytes; ++i) {
+    bytes[i] = static_cast<char>(
+        (header >> (8 * (Constants::HeaderSizeBytes - 1 - i))) & 0xFF);
+  }
+  videoDataWriter_->writePartialData(bytes, sizeof(bytes));
+}
+
+void FileFrameSink::frameChunk(const char *data, size_t size) {
+  videoDataWriter_->writePartialData(data, size);
+}
+
+void FileFrameSink::endFrame(
+    std::chrono::system_clock::time_point arrivalTime) {
+  VT_TRACE_SCOPE("FileFrameSink::endFrame");
+  videoDataWriter_->finishDataUnit();
+  timestampWriter_->write(unit_, arrivalTime);
+}
+
+void FileFrameSink::rotate(std::unique_ptr<IDataFile> videoDataWriter,
+                           std::unique_ptr<ITimestampWriter> timestampWriter) {
+  rotation_.request(std::move(videoDataWriter), std::move(timestampWriter));
+}
+
+FrameAssembler::FrameAssembler(FrameHandler onFrame)
+    : onFrame_(std::move(onFrame)) {}
+
+void FrameAssembler::beginFrame(
+    uint32_t length, uint8_t flags,
+    std::chrono::system_clock::time_point /*arrivalTime*/) {
+  unit_.length = length;
+  unit_.flags = flags;
+  unit_.data.clear();
+  unit_.data.reserve(length);
+}
+
+void FrameAssembler::frameChunk(const char *data, size_t size) {
+  unit_.data.insert(unit_.data.end(), data, data + size);
+}
+
+void FrameAssembler::endFrame(
+    std::chrono::system_clock::time_point arrivalTime) {
+  onFrame_(std::move(unit_), arrivalTime);
+  unit_ = DataUnit();
+}
@@ -0,0 +1,67 @@
+#include "ImpairmentModel.hpp"
+
+#include <algorithm>
+
+ImpairmentModel::ImpairmentModel(ImpairmentConfig config)
+    : config_(config), fragmenting_(config.maxSegmentBytes > 0),
+      random_(config.seed) {
+  config_.minSegmentBytes = std::max<size_t>(config_.minSegmentBytes, 1);
+  config_.maxSegmentBytes =
+      std::max(config_.maxSegmentBytes, config_.minSegmentBytes);
+}
+
+void ImpairmentModel::startSegment() {
+  if (fragmenting_) {
+    segmentRemaining_ = std::uniform_int_distribution<size_t>(
+        config_.minSegmentBytes, config_.maxSegmentBytes)(random_);
+  }
+
+  auto latency = config_.delay;
+  if (config_.jitter.count() > 0) {
+    latency += std::chrono::microseconds(
+        std::uniform_int_distribution<int64_t>(-config_.jitter.count(),
+                                               config_.jitter.count())(random_));
+  }
+  segmentLatency_ = std::max(latency, std::chrono::microseconds(0));
+
+  segmentStalls_ = config_.stallProbability > 0 &&
+                   std::bernoulli_distribution(config_.stallProbability)(random_);
+}
+
+std::vector<ImpairmentModel::Segment>
+ImpairmentModel::schedule(size_t size, Clock::time_point arrival) {
+  std::vector<Segment> segments;
+  size_t offset = 0;
+  while (offset < size) {
+    // Without fragmentation every read is one segment. With it, a segment
+    // drawn larger than the read continues into the next read, keeping the
+    // cut points independent of how the kernel delivered the bytes.
+    bool newSegment = !fragmenting_ || segmentRemaining_ == 0;
+    if (newSegment) {
+      startSegment();
+    }
+    size_t length =
+        fragmenting_ ? std::min(segmentRemaining_, size - offset) : size;
+    if (fragmenting_) {
+      segmentRemaining_ -= length;
+    }
+
+    auto start = std::max(arrival + segmentLatency_, linkFree_);
+    if (newSegment && segmentStalls_) {
+      start += config_.stallDuration;
+      ++stalls_;
+    }
+    linkFree_ = start;
+    if (config_.bandwidthBytesPerSecond > 0) {
+      linkFree_ += std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(
+              static_cast<double>(length) / config_.bandwidthBytesPerSecond));
+    }
+    lastDeparture_ = std::max(linkFree_, lastDeparture_);
+
+    segments.push_back({offset, length, lastDeparture_});
+    ++segments_;
+    offset += length;
+  }
+  return segments;
+}
@@ -0,0 +1,167 @@
+#include "ImpairmentProxy.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+using boost::asio::ip::tcp;
+
+ImpairmentProxy::ImpairmentProxy(uint16_t listenPort,
+                                 const std::string &targetHost,
+                                 uint16_t targetPort, ImpairmentConfig config)
+    : acceptor_(ioContext_, tcp::endpoint(tcp::v4(), listenPort)),
+      client_(ioContext_), target_(ioContext_), departureTimer_(ioContext_),
+      port_(acceptor_.local_endpoint().port()), targetHost_(targetHost),
+      targetPort_(targetPort), model_(config),
+      bufferBytes_(std::max<size_t>(config.bufferBytes, readBuffer_.size())) {}
+
+ImpairmentProxy::~ImpairmentProxy() {
+  stop();
+  wait();
+}
+
+void ImpairmentProxy::start() {
+  acceptor_.async_accept(client_,
+                         [this](const boost::system::error_code &error) {
+                           onAccepted(error);
+                         });
+  thread_ = std::thread([this]() { ioContext_.run(); });
+}
+
+void ImpairmentProxy::wait() {
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void ImpairmentProxy::stop() {
+  boost::asio::post(ioContext_, [this]() {
+    departureTimer_.cancel();
+    boost::system::error_code ignored;
+    acceptor_.close(ignored);
+    client_.close(ignored);
+    target_.close(ignored);
+  });
+}
+
+void ImpairmentProxy::onAccepted(const boost::system::error_code &error) {
+  if (error) {
+    if (error != boost::asio::error::operation_aborted) {
+      std::cerr << "Proxy accept error: " + error.message() << std::endl;
+    }
+    return;
+  }
+  boost::system::error_code ignored;
+  // One proxied connection per proxy, like the receiver.
+  acceptor_.close(ignored);
+  try {
+    tcp::resolver resolver(ioContext_);
+    boost::asio::connect(target_, resolver.resolve(
+                                      targetHost_, std::to_string(targetPort_)));
+    client_.set_option(tcp::no_delay(true));
+    target_.set_option(tcp::no_delay(true));
+    readNextData();
+  } catch (const std::exception &ex) {
+    std::cerr << "Proxy could not reach target: " << ex.what() << std::endl;
+    client_.close(ignored);
+  }
+}
+
+void ImpairmentProxy::readNextData() {
+  client_.async_read_some(
+      boost::asio::buffer(readBuffer_),
+      makeRecyclingHandler(readHandlerMemory_,
+                           [this](const boost::system::error_code &error,
+                                  std::size_t bytesRead) {
+                             onDataRead(error, bytesRead);
+                           }));
+}
+
+void ImpairmentProxy::onDataRead(const boost::system::error_code &error,
+                                 std::size_t bytesRead) {
+  if (error) {
+    if (error != boost::asio::error::eof &&
+        error != boost::asio::error::operation_aborted) {
+      std::cerr << "Proxy read error: " + error.message() << std::endl;
+    }
+    clientFinished_ = true;
+    if (!forwarding_) {
+      finish();
+    }
+    return;
+  }
+
+  auto stallsBefore = model_.getStalls();
+  for (const auto &segment : model_.schedule(
+           bytesRead, ImpairmentModel::Clock::now())) {
+    pending_.push_back(
+        {std::vector<char>(readBuffer_.begin() + segment.offset,
+                           readBuffer_.begin() + segment.offset + segment.size),
+         segment.departure});
+    pendingBytes_ += segment.size;
+  }
+  stalls_ += model_.getStalls() - stallsBefore;
+  if (!forwarding_) {
+    forwardNextSegment();
+  }
+  // A full link buffer stops reading, so TCP pushes back on the sender.
+  if (pendingBytes_ >= bufferBytes_) {
+    readPaused_ = true;
+    return;
+  }
+  readNextData();
+}
+
+void ImpairmentProxy::forwardNextSegment() {
+  if (pending_.empty()) {
+    forwarding_ = false;
+    if (clientFinished_) {
+      finish();
+    }
+    return;
+  }
+  forwarding_ = true;
+  departureTimer_.expires_at(pending_.front().departure);
+  departureTimer_.async_wait([this](const boost::system::error_code &error) {
+    if (error || pending_.empty()) {
+      forwarding_ = false;
+      return;
+    }
+    boost::asio::async_write(
+        target_, boost::asio::buffer(pending_.front().data),
+        makeRecyclingHandler(
+            writeHandlerMemory_,
+            [this](const boost::system::error_code &writeError,
+                   std::size_t bytesWritten) {
+              if (writeError) {
+                forwarding_ = false;
+                if (writeError != boost::asio::error::operation_aborted) {
+                  std::cerr << "Proxy write error: " + writeError.message()
+                            << std::endl;
+                  // Drop the client too, so the sender sees the target go
+                  // away as it would without the proxy.
+                  pending_.clear();
+                  pendingBytes_ = 0;
+                  finish();
+                }
+                return;
+              }
+              bytesForwarded_ += bytesWritten;
+              ++segmentsForwarded_;
+              pendingBytes_ -= pending_.front().data.size();
+              pending_.pop_front();
+              if (readPaused_ && pendingBytes_ < bufferBytes_ / 2) {
+                readPaused_ = false;
+                readNextData();
+              }
+              forwardNextSegment();
+            }));
+  });
+}
+
+void ImpairmentProxy::finish() {
+  // Pass the client's end of stream on once every segment has left.
+  boost::system::error_code ignored;
+  target_.shutdown(tcp::socket::shutdown_send, ignored);
+  target_.close(ignored);
+  client_.close(ignored);
+}
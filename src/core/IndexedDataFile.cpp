@@ -0,0 +1,38 @@
+#include "IndexedDataFile.hpp"
+#include "Constants.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+IndexedDataFile::IndexedDataFile(const std::string &filename)
+    : file_(filename), index_(FrameIndex::loadOrBuild(filename, file_)) {}
+
+void IndexedDataFile::writeBinaryData(const std::vector<char> &) {
+  throw std::runtime_error("IndexedDataFile is read-only");
+}
+
+std::optional<std::vector<char>> IndexedDataFile::readNextDataUnit() {
+  if (nextFrame_ >= index_.size()) {
+    return std::nullopt;
+  }
+  const auto &entry = index_[nextFrame_++];
+  const char *begin = file_.data() + entry.offset;
+
+  // Leave room for the stream ID a multiplexed sender prepends.
+  std::vector<char> dataUnit;
+  dataUnit.reserve(Constants::StreamIdSizeBytes + Constants::HeaderSizeBytes +
+                   entry.length);
+  dataUnit.assign(begin, begin + Constants::HeaderSizeBytes + entry.length);
+  return dataUnit;
+}
+
+size_t IndexedDataFile::prefault(size_t frames) {
+  frames = std::min(frames, index_.size());
+  if (frames == 0) {
+    return 0;
+  }
+  const auto &last = index_[frames - 1];
+  size_t bytes = last.offset + Constants::HeaderSizeBytes + last.length;
+  file_.willNeed(0, bytes);
+  return bytes;
+}
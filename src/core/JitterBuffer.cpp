@@ -0,0 +1,245 @@
+#include "JitterBuffer.hpp"
+#include "DataUnitConverter.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+double JitterBuffer::Stats::averageOccupancy() const {
+  return occupancySamples > 0
+             ? static_cast<double>(occupancySum) / occupancySamples
+             : 0.0;
+}
+
+JitterBuffer::JitterBuffer(std::unique_ptr<IDataAcceptor> inner,
+                           JitterBufferConfig config)
+    : inner_(std::move(inner)), config_(config),
+      converter_(std::make_unique<DataUnitConverter>()),
+      ring_(std::max<size_t>(config.capacity, 1)),
+      target_(std::clamp(config.initialDelay, config.minDelay,
+                         config.maxDelay)) {
+  playoutThread_ = std::thread([this]() {
+    if (config_.threadInit) {
+      config_.threadInit();
+    }
+    playout();
+  });
+}
+
+JitterBuffer::~JitterBuffer() { drain(); }
+
+void JitterBuffer::processRawData(const std::vector<char> &rawData) {
+  processRawData(rawData, std::chrono::system_clock::now());
+}
+
+void JitterBuffer::processRawData(
+    const std::vector<char> &rawData,
+    std::chrono::system_clock::time_point) {
+  // Scheduling runs on the local steady clock; the inner acceptor records
+  // playout times.
+  auto arrival = Clock::now();
+  totalBytesReceived_ += rawData.size();
+  auto dataUnit = converter_->decodeDataUnit(rawData);
+  while (dataUnit.has_value()) {
+    push(nextSequence_++, converter_->encodeDataUnit(dataUnit.value()),
+         arrival);
+    dataUnit = converter_->decodeDataUnit({});
+  }
+}
+
+size_t JitterBuffer::getDataUnitsReceived() const {
+  return inner_->getDataUnitsReceived();
+}
+
+size_t JitterBuffer::getTotalBytesReceived() const {
+  return totalBytesReceived_;
+}
+
+void JitterBuffer::push(uint64_t sequence, std::vector<char> frame,
+                        Clock::time_point arrival) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (failed_) {
+    throw std::runtime_error("Jitter buffer playout failed: " + stats_.error);
+  }
+  if (sequence < playoutSequence_) {
+    // Its slot has already been skipped and counted as lost.
+    stats_.lateFrames++;
+    return;
+  }
+  if (sequence >= playoutSequence_ + ring_.size()) {
+    stats_.overflows++;
+    hurry_ = true;
+    frameArrived_.notify_one();
+    spaceAvailable_.wait(lock, [&]() {
+      return sequence < playoutSequence_ + ring_.size() || draining_ ||
+             failed_;
+    });
+    hurry_ = false;
+    if (failed_) {
+      throw std::runtime_error("Jitter buffer playout failed: " +
+                               stats_.error);
+    }
+  }
+
+  if (!started_) {
+    started_ = true;
+    baseArrival_ = arrival;
+    lastArrival_ = arrival;
+  } else if (arrival > dueTime(sequence)) {
+    stats_.lateFrames++;
+  }
+  updateTarget(sequence, arrival);
+
+  Slot &slot = ring_[sequence % ring_.size()];
+  if (!slot.filled) {
+    occupancy_++;
+  }
+  slot.filled = true;
+  slot.sequence = sequence;
+  slot.frame = std::move(frame);
+
+  stats_.maxOccupancy = std::max(stats_.maxOccupancy, occupancy_);
+  stats_.occupancySum += occupancy_;
+  stats_.occupancySamples++;
+  frameArrived_.notify_one();
+}
+
+void JitterBuffer::drain() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    draining_ = true;
+  }
+  frameArrived_.notify_one();
+  spaceAvailable_.notify_all();
+  if (playoutThread_.joinable()) {
+    playoutThread_.join();
+  }
+}
+
+JitterBuffer::Stats JitterBuffer::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.targetDelay =
+      std::chrono::duration_cast<std::chrono::microseconds>(target_);
+  stats.jitter = std::chrono::duration_cast<std::chrono::microseconds>(jitter_);
+  return stats;
+}
+
+size_t JitterBuffer::getOccupancy() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return occupancy_;
+}
+
+JitterBuffer::Clock::time_point
+JitterBuffer::dueTime(uint64_t sequence) const {
+  auto due = baseArrival_ + nominalOffset(sequence) +
+             std::chrono::duration_cast<Clock::duration>(target_);
+  // Never schedule before the previous release, whatever the target did.
+  return std::max(due, lastRelease_);
+}
+
+std::chrono::microseconds
+JitterBuffer::nominalOffset(uint64_t sequence) const {
+  return config_.interval * static_cast<int64_t>(sequence);
+}
+
+void JitterBuffer::updateTarget(uint64_t sequence, Clock::time_point arrival) {
+  // Interarrival jitter as in RFC 3550: a running mean of the deviation
+  // from the nominal interval.
+  if (sequence > 0) {
+    std::chrono::duration<double, std::micro> deviation =
+        arrival - lastArrival_ - config_.interval;
+    jitter_ += (std::chrono::duration<double, std::micro>(
+                    std::abs(deviation.count())) -
+                jitter_) /
+               16.0;
+  }
+  lastArrival_ = std::max(lastArrival_, arrival);
+
+  std::chrono::duration<double, std::micro> lateness =
+      arrival - baseArrival_ - nominalOffset(sequence);
+  std::chrono::duration<double, std::micro> minDelay = config_.minDelay;
+  std::chrono::duration<double, std::micro> maxDelay = config_.maxDelay;
+  auto desired = std::clamp(jitter_ * JitterMultiplier, minDelay, maxDelay);
+  if (lateness > target_) {
+    target_ = std::min(lateness, maxDelay);
+  } else if (desired > target_) {
+    target_ = desired;
+  } else {
+    target_ += (desired - target_) / static_cast<double>(DecaySteps);
+  }
+}
+
+void JitterBuffer::playout() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    Slot &slot = ring_[playoutSequence_ % ring_.size()];
+    bool ready = slot.filled && slot.sequence == playoutSequence_;
+    if (!ready) {
+      if (draining_ && occupancy_ == 0) {
+        break;
+      }
+      if (occupancy_ > 0 && (hurry_ || draining_)) {
+        // The ring is full or the stream ended with a gap: skip it.
+        stats_.lostFrames++;
+        playoutSequence_++;
+        spaceAvailable_.notify_all();
+        continue;
+      }
+      if (started_ && Clock::now() >= dueTime(playoutSequence_) &&
+          underrunSequence_ != playoutSequence_) {
+        stats_.underruns++;
+        underrunSequence_ = playoutSequence_;
+      }
+      if (started_ && underrunSequence_ != playoutSequence_) {
+        frameArrived_.wait_until(lock, dueTime(playoutSequence_));
+      } else {
+        frameArrived_.wait(lock);
+      }
+      continue;
+    }
+
+    auto due = dueTime(playoutSequence_);
+    if (!hurry_ && Clock::now() + SpinThreshold < due) {
+      // Sleep until shortly before the slot, then re-check: the target may
+      // have moved or the ring may have filled up meanwhile.
+      frameArrived_.wait_until(lock, due - SpinThreshold);
+      continue;
+    }
+
+    std::vector<char> frame = std::move(slot.frame);
+    slot.filled = false;
+    occupancy_--;
+    playoutSequence_++;
+    lock.unlock();
+    spaceAvailable_.notify_all();
+
+    while (Clock::now() < due) {
+      // Spin out the last few microseconds for a precise release.
+    }
+    try {
+      VT_TRACE_SCOPE("jitterPlayout");
+      inner_->processRawData(frame, std::chrono::system_clock::now());
+    } catch (const std::exception &ex) {
+      std::cerr << "Exception in jitter buffer playout: " << ex.what()
+                << std::endl;
+      lock.lock();
+      stats_.error = ex.what();
+      failed_ = true;
+      for (auto &held : ring_) {
+        held.filled = false;
+        held.frame.clear();
+      }
+      occupancy_ = 0;
+      lock.unlock();
+      spaceAvailable_.notify_all();
+      return;
+    }
+
+    lock.lock();
+    lastRelease_ = std::max(due, Clock::now());
+    stats_.framesReleased++;
+  }
+}
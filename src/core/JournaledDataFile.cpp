@@ -0,0 +1,191 @@
+#include "JournaledDataFile.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+JournaledDataFile::JournaledDataFile(const std::string &filename,
+                                     const std::string &timestampFileName,
+                                     size_t commitFrames,
+                                     std::chrono::milliseconds commitInterval,
+                                     uint64_t preallocateBytes)
+    : filename_(filename), timestampFileName_(timestampFileName),
+      commitFrames_(std::max<size_t>(commitFrames, 1)),
+      commitInterval_(commitInterval), preallocateBytes_(preallocateBytes),
+      journal_(filename), lastCommitAt_(std::chrono::steady_clock::now()) {
+  file_.open(filename, std::ios::binary | std::ios::out | std::ios::trunc);
+  if (!file_.is_open()) {
+    throw std::runtime_error("Could not open file for writing: " + filename);
+  }
+  // fstream hides its descriptor; a second one syncs and preallocates.
+  syncFd_ = ::open(filename.c_str(), O_WRONLY);
+  if (syncFd_ < 0) {
+    throw std::runtime_error("Could not open file for syncing: " + filename +
+                             ": " + std::strerror(errno));
+  }
+  // An empty first commit marks the capture as journaled from the start.
+  journal_.commit(0, 0, 0);
+  committer_ = std::thread([this]() { runCommitter(); });
+  std::cout << "Output file opened: " + filename + " (journaled)" << std::endl;
+}
+
+JournaledDataFile::~JournaledDataFile() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_one();
+  committer_.join();
+  try {
+    commit();
+  } catch (const std::exception &e) {
+    std::cerr << "Final commit of " + filename_ + " failed: " + e.what()
+              << std::endl;
+  }
+  file_.close();
+  ::close(syncFd_);
+  if (timestampFd_ >= 0) {
+    ::close(timestampFd_);
+  }
+  std::cout << "Output file closed. Total bytes written: " +
+                   std::to_string(bytesWritten_) + ", " +
+                   std::to_string(journal_.getCommitCount()) + " commits"
+            << std::endl;
+}
+
+void JournaledDataFile::writeBinaryData(const std::vector<char> &data) {
+  VT_TRACE_SCOPE("writeBinaryData");
+  writePartialData(data.data(), data.size());
+  finishDataUnit();
+}
+
+std::optional<std::vector<char>> JournaledDataFile::readNextDataUnit() {
+  throw std::runtime_error("Journaled capture is write-only: " + filename_);
+}
+
+void JournaledDataFile::writePartialData(const char *data, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A commit falls due when a unit completes but is taken before the next
+  // one starts, once the timestamp of the completed unit is logged.
+  if (commitDue_) {
+    commitLocked();
+  }
+  preallocate(bytesWritten_ + size);
+  file_.write(data, size);
+  bytesWritten_ += size;
+}
+
+void JournaledDataFile::finishDataUnit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  timestampBytesAtFinish_ = timestampLogSize();
+  frames_++;
+  finishedBytes_ = bytesWritten_;
+  commitDue_ =
+      frames_ - committedFrames_ >= commitFrames_ ||
+      std::chrono::steady_clock::now() - lastCommitAt_ >= commitInterval_;
+}
+
+void JournaledDataFile::commit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  commitLocked();
+}
+
+void JournaledDataFile::commitLocked() {
+  VT_TRACE_SCOPE("JournaledDataFile::commit");
+  commitDue_ = false;
+  lastCommitAt_ = std::chrono::steady_clock::now();
+  if (frames_ == committedFrames_) {
+    return;
+  }
+
+  file_.flush();
+  if (::fdatasync(syncFd_) != 0) {
+    throw std::runtime_error("Could not sync " + filename_ + ": " +
+                             std::strerror(errno));
+  }
+  uint64_t timestampBytes = 0;
+  if (!timestampFileName_.empty()) {
+    if (timestampFd_ < 0) {
+      timestampFd_ = ::open(timestampFileName_.c_str(), O_RDONLY);
+    }
+    struct stat status {};
+    if (timestampFd_ < 0 || ::fdatasync(timestampFd_) != 0 ||
+        ::fstat(timestampFd_, &status) != 0) {
+      throw std::runtime_error("Could not sync " + timestampFileName_ + ": " +
+                               std::strerror(errno));
+    }
+    timestampBytes = static_cast<uint64_t>(status.st_size);
+  }
+  journal_.commit(frames_, finishedBytes_, timestampBytes);
+  committedFrames_ = frames_;
+}
+
+uint64_t JournaledDataFile::timestampLogSize() {
+  if (timestampFileName_.empty()) {
+    return 0;
+  }
+  if (timestampFd_ < 0) {
+    timestampFd_ = ::open(timestampFileName_.c_str(), O_RDONLY);
+  }
+  struct stat status {};
+  if (timestampFd_ < 0 || ::fstat(timestampFd_, &status) != 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(status.st_size);
+}
+
+void JournaledDataFile::runCommitter() {
+  // Without this, the last units before a pause would stay uncommitted
+  // until the next unit or the close.
+  auto period = std::max<std::chrono::milliseconds>(
+      commitInterval_, std::chrono::milliseconds(1));
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    wake_.wait_for(lock, period);
+    if (stopping_ || frames_ == committedFrames_) {
+      continue;
+    }
+    bool due = commitDue_ ||
+               std::chrono::steady_clock::now() - lastCommitAt_ >= period;
+    // The log line of the last unit follows it; wait until it is in.
+    bool logged = timestampFileName_.empty() ||
+                  timestampLogSize() > timestampBytesAtFinish_;
+    if (!due || !logged) {
+      continue;
+    }
+    try {
+      commitLocked();
+    } catch (const std::exception &e) {
+      std::cerr << "Commit of " + filename_ + " failed: " + e.what()
+                << std::endl;
+    }
+  }
+}
+
+void JournaledDataFile::preallocate(uint64_t endOffset) {
+#ifdef __linux__
+  if (preallocateBytes_ == 0 || endOffset <= preallocatedBytes_) {
+    return;
+  }
+  uint64_t length = std::max(preallocateBytes_, endOffset - preallocatedBytes_);
+  // Reserves blocks without changing the size, so readers and recovery see
+  // only written data.
+  if (::fallocate(syncFd_, FALLOC_FL_KEEP_SIZE,
+                  static_cast<off_t>(preallocatedBytes_),
+                  static_cast<off_t>(length)) != 0) {
+    // Not supported by every file system; carry on without it.
+    preallocateBytes_ = 0;
+    return;
+  }
+  preallocatedBytes_ += length;
+#else
+  (void)endOffset;
+#endif
+}
@@ -0,0 +1,195 @@
+#include "Codec.hpp"
+
+#include <array>
+#include <cstring>
+
+// LZ4 block format: sequences of
+//   token (literal length << 4 | match length - 4), literal length bytes,
+//   literals, 2-byte little-endian match offset, match length bytes,
+// where a 15 in either token nibble continues in 255-valued extra bytes.
+// The last sequence carries literals only.
+namespace {
+constexpr size_t MinMatch = 4;
+constexpr size_t LastLiterals = 5; // the block always ends in literals
+constexpr size_t MatchFindLimit = 12; // no match may start this close to end
+constexpr size_t MaxOffset = 65535;
+constexpr int HashBits = 12;
+
+uint32_t read32(const char *pointer) {
+  uint32_t value;
+  std::memcpy(&value, pointer, sizeof(value));
+  return value;
+}
+
+uint32_t hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+class BlockWriter {
+public:
+  BlockWriter(char *destination, size_t capacity)
+      : destination_(destination), capacity_(capacity) {}
+
+  bool sequence(const char *literals, size_t literalLength,
+                size_t matchOffset, size_t matchLength) {
+    size_t tokenPosition = position_;
+    if (!put(0)) {
+      return false;
+    }
+    uint8_t token = static_cast<uint8_t>(
+        (literalLength >= 15 ? 15 : literalLength) << 4);
+    if (!putLength(literalLength) || !putBytes(literals, literalLength)) {
+      return false;
+    }
+    if (matchLength > 0) {
+      size_t extra = matchLength - MinMatch;
+      token |= static_cast<uint8_t>(extra >= 15 ? 15 : extra);
+      if (!put(static_cast<uint8_t>(matchOffset & 0xFF)) ||
+          !put(static_cast<uint8_t>(matchOffset >> 8)) || !putLength(extra)) {
+        return false;
+      }
+    }
+    destination_[tokenPosition] = static_cast<char>(token);
+    return true;
+  }
+
+  size_t size() const { return position_; }
+
+private:
+  bool put(uint8_t byte) {
+    if (position_ >= capacity_) {
+      return false;
+    }
+    destination_[position_++] = static_cast<char>(byte);
+    return true;
+  }
+
+  bool putLength(size_t length) {
+    if (length < 15) {
+      return true;
+    }
+    for (length -= 15; length >= 255; length -= 255) {
+      if (!put(255)) {
+        return false;
+      }
+    }
+    return put(static_cast<uint8_t>(length));
+  }
+
+  bool putBytes(const char *bytes, size_t count) {
+    if (capacity_ - position_ < count) {
+      return false;
+    }
+    std::memcpy(destination_ + position_, bytes, count);
+    position_ += count;
+    return true;
+  }
+
+  char *destination_;
+  size_t capacity_;
+  size_t position_ = 0;
+};
+} // namespace
+
+size_t Lz4Codec::compress(const char *source, size_t size, char *destination,
+                          size_t capacity) const {
+  BlockWriter writer(destination, capacity);
+  size_t anchor = 0;
+
+  if (size > MatchFindLimit) {
+    std::array<int32_t, 1 << HashBits> table;
+    table.fill(-1);
+    size_t matchLimit = size - LastLiterals;
+    size_t position = 0;
+    while (position < size - MatchFindLimit) {
+      uint32_t sequence = read32(source + position);
+      uint32_t slot = hash(sequence);
+      int32_t candidate = table[slot];
+      table[slot] = static_cast<int32_t>(position);
+
+      if (candidate < 0 ||
+          position - static_cast<size_t>(candidate) > MaxOffset ||
+          read32(source + candidate) != sequence) {
+        ++position;
+        continue;
+      }
+
+      size_t match = static_cast<size_t>(candidate);
+      size_t matchLength = MinMatch;
+      while (position + matchLength < matchLimit &&
+             source[match + matchLength] == source[position + matchLength]) {
+        ++matchLength;
+      }
+      if (!writer.sequence(source + anchor, position - anchor,
+                           position - match, matchLength)) {
+        return 0;
+      }
+      position += matchLength;
+      anchor = position;
+    }
+  }
+
+  if (!writer.sequence(source + anchor, size - anchor, 0, 0)) {
+    return 0;
+  }
+  return writer.size();
+}
+
+bool Lz4Codec::decompress(const char *source, size_t size, char *destination,
+                          size_t originalSize) const {
+  const auto *input = reinterpret_cast<const uint8_t *>(source);
+  size_t in = 0;
+  size_t out = 0;
+
+  auto readLength = [&](size_t &length) {
+    if (length != 15) {
+      return true;
+    }
+    uint8_t byte;
+    do {
+      if (in >= size) {
+        return false;
+      }
+      byte = input[in++];
+      length += byte;
+    } while (byte == 255);
+    return true;
+  };
+
+  for (;;) {
+    if (in >= size) {
+      return false;
+    }
+    uint8_t token = input[in++];
+
+    size_t literalLength = token >> 4;
+    if (!readLength(literalLength) || size - in < literalLength ||
+        originalSize - out < literalLength) {
+      return false;
+    }
+    std::memcpy(destination + out, source + in, literalLength);
+    in += literalLength;
+    out += literalLength;
+    if (in == size) {
+      return out == originalSize;
+    }
+
+    if (size - in < 2) {
+      return false;
+    }
+    size_t offset = input[in] | (static_cast<size_t>(input[in + 1]) << 8);
+    in += 2;
+    size_t matchLength = token & 0x0F;
+    if (offset == 0 || offset > out || !readLength(matchLength)) {
+      return false;
+    }
+    matchLength += MinMatch;
+    if (originalSize - out < matchLength) {
+      return false;
+    }
+    // Byte by byte: a match may overlap the bytes it produces.
+    for (size_t i = 0; i < matchLength; ++i, ++out) {
+      destination[out] = destination[out - offset];
+    }
+  }
+}
@@ -0,0 +1,63 @@
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open file for reading: " + filename);
+  }
+
+  struct stat info {};
+  if (fstat(fd, &info) != 0) {
+    int error = errno;
+    close(fd);
+    throw std::runtime_error("Could not stat file " + filename + ": " +
+                             std::strerror(error));
+  }
+  size_ = static_cast<size_t>(info.st_size);
+
+  if (size_ > 0) {
+    void *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      int error = errno;
+      close(fd);
+      throw std::runtime_error("Could not map file " + filename + ": " +
+                               std::strerror(error));
+    }
+    data_ = static_cast<const char *>(mapping);
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char *>(data_), size_);
+  }
+}
+
+void MappedFile::willNeed(size_t offset, size_t length) const {
+  if (data_ == nullptr || offset >= size_) {
+    return;
+  }
+  length = std::min(length, size_ - offset);
+
+  size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t alignedOffset = offset - offset % pageSize;
+  madvise(const_cast<char *>(data_) + alignedOffset,
+          offset + length - alignedOffset, MADV_WILLNEED);
+
+  volatile char sink = 0;
+  for (size_t page = alignedOffset; page < offset + length; page += pageSize) {
+    sink = data_[page];
+  }
+  (void)sink;
+}
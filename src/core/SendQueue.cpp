@@ -0,0 +1,58 @@
+#include "SendQueue.hpp"
+
+#include <algorithm>
+
+SendQueue::SendQueue(size_t capacity, std::chrono::milliseconds maxLatency)
+    : capacity_(capacity), maxLatency_(maxLatency) {}
+
+bool SendQueue::push(std::shared_ptr<std::vector<char>> frame, bool keyframe,
+                     Clock::time_point now) {
+  Entry entry{std::move(frame), keyframe,
+              maxLatency_.count() > 0 ? now + maxLatency_
+                                      : Clock::time_point::max()};
+
+  if (capacity_ > 0 && entries_.size() >= capacity_) {
+    auto oldestDelta =
+        std::find_if(entries_.begin(), entries_.end(),
+                     [](const Entry &queued) { return !queued.keyframe; });
+    if (oldestDelta != entries_.end()) {
+      drop(*oldestDelta);
+      entries_.erase(oldestDelta);
+    } else if (!entry.keyframe) {
+      drop(entry);
+      return false;
+    }
+    // A queue full of keyframes still accepts another keyframe.
+  }
+
+  entries_.push_back(std::move(entry));
+  return true;
+}
+
+std::optional<SendQueue::Entry> SendQueue::pop(Clock::time_point now) {
+  while (!entries_.empty()) {
+    Entry entry = std::move(entries_.front());
+    entries_.pop_front();
+    if (!entry.keyframe && entry.deadline < now) {
+      drop(entry);
+      continue;
+    }
+    return entry;
+  }
+  return std::nullopt;
+}
+
+void SendQueue::clear() { entries_.clear(); }
+
+bool SendQueue::empty() const { return entries_.empty(); }
+
+size_t SendQueue::size() const { return entries_.size(); }
+
+uint64_t SendQueue::getDroppedFrames() const { return droppedFrames_; }
+
+uint64_t SendQueue::getDroppedBytes() const { return droppedBytes_; }
+
+void SendQueue::drop(const Entry &entry) {
+  ++droppedFrames_;
+  droppedBytes_ += entry.frame->size();
+}
@@ -0,0 +1,251 @@
+#include "SharedMemoryRing.hpp"
+#include "Constants.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr uint32_t RingMagic = 0x56545352; // "VTSR"
+constexpr uint32_t RingVersion = 1;
+constexpr uint32_t SlotDataSize = Constants::MaxPacketSize;
+
+enum ProducerState : uint32_t { Idle = 0, Attached = 1, Finished = 2 };
+
+#ifdef __linux__
+// Bounded wait so a missed wake-up (e.g. a peer that died between updating
+// the ring and waking us) only costs one timeout.
+void futexWait(std::atomic<uint32_t> &word, uint32_t expected) {
+  timespec timeout{0, 100 * 1000 * 1000};
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected,
+          &timeout, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t> &word) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, 1,
+          nullptr, nullptr, 0);
+}
+#endif
+} // namespace
+
+struct SharedMemoryRing::Header {
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+  uint32_t slotCount;
+  uint32_t slotDataSize;
+  alignas(64) std::atomic<uint64_t> writeSequence;
+  std::atomic<uint32_t> dataSignal;
+  std::atomic<uint32_t> producerState;
+  alignas(64) std::atomic<uint64_t> readSequence;
+  std::atomic<uint32_t> spaceSignal;
+};
+
+struct SharedMemoryRing::Slot {
+  std::atomic<uint64_t> sequence; // frame sequence + 1 once published
+  uint32_t length;
+  char data[SlotDataSize];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<uint32_t>::is_always_lock_free,
+              "Shared-memory ring needs address-free atomics");
+
+#ifdef __linux__
+SharedMemoryRing::SharedMemoryRing(const std::string &name, Role role,
+                                   uint32_t slotCount)
+    : name_(name), role_(role) {
+  if (slotCount == 0) {
+    throw std::runtime_error("Shared-memory ring needs at least one slot");
+  }
+  mappedSize_ = sizeof(Header) + sizeof(Slot) * slotCount;
+
+  bool created = true;
+  fd_ = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd_ < 0 && errno == EEXIST) {
+    created = false;
+    fd_ = shm_open(name.c_str(), O_RDWR, 0600);
+  }
+  if (fd_ < 0) {
+    throw std::runtime_error("Could not open shared memory " + name + ": " +
+                             std::strerror(errno));
+  }
+
+  if (created) {
+    if (ftruncate(fd_, static_cast<off_t>(mappedSize_)) != 0) {
+      int error = errno;
+      close(fd_);
+      shm_unlink(name.c_str());
+      throw std::runtime_error("Could not size shared memory " + name + ": " +
+                               std::strerror(error));
+    }
+  } else {
+    // The creator may still be sizing the segment.
+    struct stat info {};
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+      if (fstat(fd_, &info) == 0 && info.st_size > 0) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (info.st_size < static_cast<off_t>(sizeof(Header))) {
+      close(fd_);
+      throw std::runtime_error("Shared memory " + name + " is not initialized");
+    }
+    mappedSize_ = static_cast<size_t>(info.st_size);
+  }
+
+  mapping_ = mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  fd_, 0);
+  if (mapping_ == MAP_FAILED) {
+    int error = errno;
+    close(fd_);
+    throw std::runtime_error("Could not map shared memory " + name + ": " +
+                             std::strerror(error));
+  }
+  header_ = static_cast<Header *>(mapping_);
+
+  if (created) {
+    header_->version = RingVersion;
+    header_->slotCount = slotCount;
+    header_->slotDataSize = SlotDataSize;
+    header_->writeSequence.store(0);
+    header_->readSequence.store(0);
+    header_->dataSignal.store(0);
+    header_->spaceSignal.store(0);
+    header_->producerState.store(Idle);
+    header_->magic.store(RingMagic, std::memory_order_release);
+  } else {
+    for (int attempt = 0; attempt < 1000 &&
+                          header_->magic.load(std::memory_order_acquire) !=
+                              RingMagic;
+         ++attempt) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header_->magic.load(std::memory_order_acquire) != RingMagic ||
+        header_->version != RingVersion ||
+        header_->slotDataSize != SlotDataSize ||
+        mappedSize_ < sizeof(Header) + sizeof(Slot) * header_->slotCount) {
+      munmap(mapping_, mappedSize_);
+      close(fd_);
+      throw std::runtime_error("Shared memory " + name +
+                               " has an incompatible layout");
+    }
+  }
+
+  if (role_ == Role::Producer) {
+    header_->producerState.store(Attached, std::memory_order_release);
+  } else if (header_->producerState.load(std::memory_order_acquire) ==
+                 Finished &&
+             header_->readSequence.load() == header_->writeSequence.load()) {
+    // Leftover of a completed session: wait for the next producer.
+    header_->producerState.store(Idle, std::memory_order_release);
+  }
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+  munmap(mapping_, mappedSize_);
+  close(fd_);
+}
+
+void SharedMemoryRing::publish(const char *data, size_t size) {
+  if (size > SlotDataSize) {
+    throw std::runtime_error("Frame of " + std::to_string(size) +
+                             " bytes exceeds shared-memory slot size " +
+                             std::to_string(SlotDataSize));
+  }
+
+  uint64_t sequence = header_->writeSequence.load(std::memory_order_relaxed);
+  for (;;) {
+    uint32_t signal = header_->spaceSignal.load(std::memory_order_acquire);
+    if (sequence - header_->readSequence.load(std::memory_order_acquire) <
+        header_->slotCount) {
+      break;
+    }
+    futexWait(header_->spaceSignal, signal);
+  }
+
+  Slot &target = slot(sequence);
+  std::memcpy(target.data, data, size);
+  target.length = static_cast<uint32_t>(size);
+  target.sequence.store(sequence + 1, std::memory_order_release);
+  header_->writeSequence.store(sequence + 1, std::memory_order_release);
+  header_->dataSignal.fetch_add(1, std::memory_order_release);
+  futexWake(header_->dataSignal);
+}
+
+void SharedMemoryRing::finish() {
+  header_->producerState.store(Finished, std::memory_order_release);
+  header_->dataSignal.fetch_add(1, std::memory_order_release);
+  futexWake(header_->dataSignal);
+}
+
+std::optional<std::vector<char>> SharedMemoryRing::consume() {
+  uint64_t sequence = header_->readSequence.load(std::memory_order_relaxed);
+  for (;;) {
+    uint32_t signal = header_->dataSignal.load(std::memory_order_acquire);
+    Slot &source = slot(sequence);
+    if (source.sequence.load(std::memory_order_acquire) == sequence + 1) {
+      std::vector<char> frame(source.data, source.data + source.length);
+      header_->readSequence.store(sequence + 1, std::memory_order_release);
+      header_->spaceSignal.fetch_add(1, std::memory_order_release);
+      futexWake(header_->spaceSignal);
+      return frame;
+    }
+    if (header_->producerState.load(std::memory_order_acquire) == Finished &&
+        header_->writeSequence.load(std::memory_order_acquire) == sequence) {
+      return std::nullopt;
+    }
+    futexWait(header_->dataSignal, signal);
+  }
+}
+
+void SharedMemoryRing::unlink(const std::string &name) {
+  shm_unlink(name.c_str());
+}
+#else
+SharedMemoryRing::SharedMemoryRing(const std::string &name, Role role,
+                                   uint32_t)
+    : name_(name), role_(role) {
+  throw std::runtime_error("Shared-memory transport requires Linux futexes");
+}
+
+SharedMemoryRing::~SharedMemoryRing() = default;
+
+void SharedMemoryRing::publish(const char *, size_t) {}
+
+void SharedMemoryRing::finish() {}
+
+std::optional<std::vector<char>> SharedMemoryRing::consume() {
+  return std::nullopt;
+}
+
+void SharedMemoryRing::unlink(const std::string &) {}
+#endif
+
+uint64_t SharedMemoryRing::getWriteSequence() const {
+  return header_->writeSequence.load(std::memory_order_acquire);
+}
+
+uint64_t SharedMemoryRing::getReadSequence() const {
+  return header_->readSequence.load(std::memory_order_acquire);
+}
+
+uint32_t SharedMemoryRing::getSlotCount() const { return header_->slotCount; }
+
+SharedMemoryRing::Slot &SharedMemoryRing::slot(uint64_t sequence) const {
+  auto *slots = reinterpret_cast<Slot *>(static_cast<char *>(mapping_) +
+                                         sizeof(Header));
+  return slots[sequence % header_->slotCount];
+}
@@ -0,0 +1,36 @@
+#include "ShmReceiver.hpp"
+#include "DataAcceptor.hpp"
+#include "SharedMemoryRing.hpp"
+
+#include <iostream>
+
+ShmReceiver::ShmReceiver(const std::string &segmentName,
+                         std::unique_ptr<IDataAcceptor> dataAcceptor)
+    : segmentName_(segmentName),
+      ring_(std::make_unique<SharedMemoryRing>(
+          segmentName, SharedMemoryRing::Role::Consumer)),
+      dataAcceptor_(std::move(dataAcceptor)) {
+  std::cout << "Shared-memory receiver attached to " + segmentName +
+                   " at sequence " + std::to_string(ring_->getReadSequence())
+            << std::endl;
+}
+
+ShmReceiver::~ShmReceiver() = default;
+
+void ShmReceiver::start() {
+  while (auto frame = ring_->consume()) {
+    dataAcceptor_->processRawData(frame.value());
+  }
+  std::cout << "Stream finished by sender" << std::endl;
+  // A clean end of stream closes the session; after a crash the segment is
+  // kept so a restarted receiver resumes from the last consumed sequence.
+  SharedMemoryRing::unlink(segmentName_);
+}
+
+size_t ShmReceiver::getDataUnitsReceived() const {
+  return dataAcceptor_ ? dataAcceptor_->getDataUnitsReceived() : 0;
+}
+
+size_t ShmReceiver::getTotalBytesReceived() const {
+  return dataAcceptor_ ? dataAcceptor_->getTotalBytesReceived() : 0;
+}
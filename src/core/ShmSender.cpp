@@ -0,0 +1,29 @@
+#include "ShmSender.hpp"
+#include "DataProvider.hpp"
+#include "DataFile.hpp"
+#include "DataUnitConverter.hpp"
+#include "SharedMemoryRing.hpp"
+
+#include <iostream>
+#include <thread>
+
+ShmSender::ShmSender(const std::string &segmentName,
+                     std::unique_ptr<IDataProvider> dataProvider)
+    : dataProvider_(std::move(dataProvider)),
+      ring_(std::make_unique<SharedMemoryRing>(
+          segmentName, SharedMemoryRing::Role::Producer)) {
+  std::cout << "Shared-memory sender attached to " + segmentName +
+                   " at sequence " + std::to_string(ring_->getWriteSequence())
+            << std::endl;
+}
+
+ShmSender::~ShmSender() = default;
+
+void ShmSender::startTransport(std::chrono::microseconds delay) {
+  while (auto data = dataProvider_->getNextData()) {
+    ring_->publish(data->data(), data->size());
+    std::this_thread::sleep_for(delay);
+  }
+  ring_->finish();
+  std::cout << "Transport completed - no more data available" << std::endl;
+}
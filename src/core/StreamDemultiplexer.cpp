@@ -0,0 +1,94 @@
+#include "StreamDemultiplexer.hpp"
+#include "Constants.hpp"
+#include "DataUnitConverter.hpp"
+
+#include <stdexcept>
+
+StreamDemultiplexer::StreamDemultiplexer(AcceptorFactory acceptorFactory)
+    : acceptorFactory_(std::move(acceptorFactory)),
+      converter_(std::make_unique<DataUnitConverter>()) {}
+
+StreamDemultiplexer::~StreamDemultiplexer() = default;
+
+void StreamDemultiplexer::processRawData(const std::vector<char> &rawData) {
+  demultiplex(rawData, std::nullopt);
+}
+
+void StreamDemultiplexer::processRawData(
+    const std::vector<char> &rawData,
+    std::chrono::system_clock::time_point arrivalTime) {
+  demultiplex(rawData, arrivalTime);
+}
+
+void StreamDemultiplexer::demultiplex(
+    const std::vector<char> &rawData,
+    std::optional<std::chrono::system_clock::time_point> arrivalTime) {
+  totalBytesReceived_ += rawData.size();
+  buffer_.insert(buffer_.end(), rawData.begin(), rawData.end());
+
+  size_t offset = 0;
+  while (buffer_.size() - offset >=
+         Constants::StreamIdSizeBytes + Constants::HeaderSizeBytes) {
+    const char *frame = buffer_.data() + offset;
+    uint16_t streamId = static_cast<uint16_t>(
+        (static_cast<unsigned char>(frame[0]) << 8) |
+        static_cast<unsigned char>(frame[1]));
+    auto length = converter_->decodeHeader(
+        frame + Constants::StreamIdSizeBytes,
+        buffer_.size() - offset - Constants::StreamIdSizeBytes);
+    if (!length.has_value()) {
+      break;
+    }
+    converter_->validateHeader(
+        frame + Constants::StreamIdSizeBytes,
+        buffer_.size() - offset - Constants::StreamIdSizeBytes);
+
+    size_t unitSize = Constants::HeaderSizeBytes + length.value();
+    if (buffer_.size() - offset < Constants::StreamIdSizeBytes + unitSize) {
+      break;
+    }
+
+    std::vector<char> unit(frame + Constants::StreamIdSizeBytes,
+                           frame + Constants::StreamIdSizeBytes + unitSize);
+    if (arrivalTime.has_value()) {
+      streamAcceptor(streamId).processRawData(unit, arrivalTime.value());
+    } else {
+      streamAcceptor(streamId).processRawData(unit);
+    }
+    offset += Constants::StreamIdSizeBytes + unitSize;
+  }
+
+  buffer_.erase(buffer_.begin(), buffer_.begin() + offset);
+}
+
+IDataAcceptor &StreamDemultiplexer::streamAcceptor(uint16_t streamId) {
+  auto it = streams_.find(streamId);
+  if (it == streams_.end()) {
+    auto acceptor = acceptorFactory_(streamId);
+    if (!acceptor) {
+      throw std::runtime_error("No acceptor for stream " +
+                               std::to_string(streamId));
+    }
+    it = streams_.emplace(streamId, std::move(acceptor)).first;
+  }
+  return *it->second;
+}
+
+size_t StreamDemultiplexer::getDataUnitsReceived() const {
+  size_t dataUnits = 0;
+  for (const auto &[streamId, acceptor] : streams_) {
+    dataUnits += acceptor->getDataUnitsReceived();
+  }
+  return dataUnits;
+}
+
+size_t StreamDemultiplexer::getTotalBytesReceived() const {
+  return totalBytesReceived_;
+}
+
+size_t StreamDemultiplexer::getStreamCount() const { return streams_.size(); }
+
+const IDataAcceptor *StreamDemultiplexer::getStream(uint16_t streamId) const {
+  auto it = streams_.find(streamId);
+  return it == streams_.end() ? nullptr : it->second.get();
+}
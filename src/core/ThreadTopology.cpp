@@ -0,0 +1,391 @@
+#include "ThreadTopology.hpp"
+#include "Constants.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr const char *NodePath = "/sys/devices/system/node/node";
+// Node masks are a single unsigned long.
+constexpr int MaxNodes = sizeof(unsigned long) * 8;
+
+// Returns 0 or the pthread error code.
+int pinCurrentThread(const std::vector<int> &cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return EINVAL;
+    }
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  return cpus.empty() ? 0 : ENOTSUP;
+#endif
+}
+
+#ifdef __linux__
+bool preferNode(int node) {
+  if (node < 0 || node >= MaxNodes) {
+    errno = EINVAL;
+    return false;
+  }
+  unsigned long mask = 1UL << node;
+  return syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask,
+                 sizeof(mask) * 8) == 0;
+}
+
+// Anonymous mapping whose pages are bound to `node` and faulted in.
+char *allocateOnNode(size_t bytes, int node) {
+  void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    throw std::runtime_error("Failed to map benchmark buffer: " +
+                             std::string(std::strerror(errno)));
+  }
+  if (node >= 0 && node < MaxNodes) {
+    unsigned long mask = 1UL << node;
+    syscall(SYS_mbind, memory, bytes, MPOL_BIND, &mask, sizeof(mask) * 8, 0);
+  }
+  std::memset(memory, 1, bytes);
+  return static_cast<char *>(memory);
+}
+
+void release(char *memory, size_t bytes) { munmap(memory, bytes); }
+#else
+char *allocateOnNode(size_t bytes, int) {
+  char *memory = new char[bytes];
+  std::memset(memory, 1, bytes);
+  return memory;
+}
+
+void release(char *memory, size_t) { delete[] memory; }
+#endif
+
+// Copies `source` frame by frame into a buffer local to the calling thread.
+double copyMBps(const char *source, size_t bytes) {
+  std::vector<char> frame(Constants::MaxPacketSize);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t offset = 0; offset + frame.size() <= bytes;
+       offset += frame.size()) {
+    std::memcpy(frame.data(), source + offset, frame.size());
+    // Keep the compiler from dropping copies nobody reads.
+    asm volatile("" : : "r"(frame.data()) : "memory");
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return seconds > 0 ? bytes / seconds / 1e6 : 0.0;
+}
+
+// Average round trip of a flag bounced between two threads.
+std::chrono::nanoseconds pingPong(const std::vector<int> &first,
+                                  const std::vector<int> &second,
+                                  int rounds) {
+  std::atomic<int> turn{0};
+  std::thread peer([&]() {
+    pinCurrentThread(second);
+    for (int i = 0; i < rounds; ++i) {
+      while (turn.load(std::memory_order_acquire) != 2 * i + 1) {
+        std::this_thread::yield();
+      }
+      turn.store(2 * i + 2, std::memory_order_release);
+    }
+  });
+  std::chrono::steady_clock::duration elapsed{};
+  std::thread self([&]() {
+    pinCurrentThread(first);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+      turn.store(2 * i + 1, std::memory_order_release);
+      while (turn.load(std::memory_order_acquire) != 2 * i + 2) {
+        std::this_thread::yield();
+      }
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+  });
+  self.join();
+  peer.join();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed) /
+         rounds;
+}
+
+std::string formatCpus(const std::vector<int> &cpus) {
+  std::string result;
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    size_t end = i;
+    while (end + 1 < cpus.size() && cpus[end + 1] == cpus[end] + 1) {
+      ++end;
+    }
+    result += (result.empty() ? "" : ",") + std::to_string(cpus[i]);
+    if (end > i) {
+      result += "-" + std::to_string(cpus[end]);
+    }
+    i = end;
+  }
+  return result;
+}
+} // namespace
+
+std::string ThreadTopology::Placement::describe() const {
+  if (empty()) {
+    return "any";
+  }
+  std::string result = cpus.empty() ? "any CPU" : "CPUs " + formatCpus(cpus);
+  if (numaNode >= 0) {
+    result += ", node " + std::to_string(numaNode);
+  }
+  return result;
+}
+
+ThreadTopology ThreadTopology::parse(const std::string &spec) {
+  ThreadTopology topology;
+  topology.inherited = currentThreadState();
+  std::stringstream entries(spec);
+  for (std::string entry; std::getline(entries, entry, '/');) {
+    auto colon = entry.find(':');
+    if (colon == std::string::npos) {
+      throw std::runtime_error("Invalid topology entry: " + entry +
+                               " (expected <stage>:<cpus>|node<n>)");
+    }
+    std::string role = entry.substr(0, colon);
+    std::string value = entry.substr(colon + 1);
+
+    Placement placement;
+    if (value.rfind("node", 0) == 0) {
+      placement.numaNode = std::stoi(value.substr(4));
+      placement.cpus = cpusOfNode(placement.numaNode);
+      if (placement.cpus.empty()) {
+        throw std::runtime_error("NUMA node " + value.substr(4) +
+                                 " has no CPUs");
+      }
+    } else {
+      placement.cpus = parseCpuList(value);
+      // The memory node follows the CPUs when they all share one.
+      int node = nodeOfCpu(placement.cpus.front());
+      bool sameNode = std::all_of(
+          placement.cpus.begin(), placement.cpus.end(),
+          [node](int cpu) { return nodeOfCpu(cpu) == node; });
+      placement.numaNode = sameNode ? node : -1;
+    }
+
+    if (role == "io") {
+      topology.io = placement;
+    } else if (role == "workers") {
+      topology.workers = placement;
+    } else if (role == "playout") {
+      topology.playout = placement;
+    } else {
+      throw std::runtime_error("Unknown topology stage: " + role +
+                               " (expected io, workers or playout)");
+    }
+  }
+  return topology;
+}
+
+std::vector<int> ThreadTopology::parseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream ranges(list);
+  for (std::string range; std::getline(ranges, range, ',');) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first
+                                         : std::stoi(range.substr(dash + 1));
+    if (first < 0 || last < first) {
+      throw std::runtime_error("Invalid CPU range: " + range);
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  if (cpus.empty()) {
+    throw std::runtime_error("Empty CPU list: " + list);
+  }
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+int ThreadTopology::nodeCount() {
+  int count = 0;
+  while (std::ifstream(NodePath + std::to_string(count) + "/cpulist")) {
+    ++count;
+  }
+  return std::max(count, 1);
+}
+
+std::vector<int> ThreadTopology::cpusOfNode(int node) {
+  std::ifstream file(NodePath + std::to_string(node) + "/cpulist");
+  std::string list;
+  if (!std::getline(file, list) || list.empty()) {
+    if (node == 0 && nodeCount() == 1) {
+      // No sysfs topology: treat the machine as one node.
+      std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+      for (size_t i = 0; i < cpus.size(); ++i) {
+        cpus[i] = static_cast<int>(i);
+      }
+      return cpus;
+    }
+    return {};
+  }
+  return parseCpuList(list);
+}
+
+int ThreadTopology::nodeOfCpu(int cpu) {
+  for (int node = 0; node < nodeCount(); ++node) {
+    auto cpus = cpusOfNode(node);
+    if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+      return node;
+    }
+  }
+  return -1;
+}
+
+const ThreadTopology::Placement &ThreadTopology::placement(Role role) const {
+  switch (role) {
+  case Role::Io:
+    return io;
+  case Role::Workers:
+    return workers;
+  case Role::Playout:
+    return playout;
+  }
+  return io;
+}
+
+ThreadTopology::ThreadState ThreadTopology::currentThreadState() {
+  ThreadState state;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        state.cpus.push_back(cpu);
+      }
+    }
+  }
+  int mode = MPOL_DEFAULT;
+  unsigned long mask = 0;
+  if (syscall(SYS_get_mempolicy, &mode, &mask, MaxNodes, nullptr, 0) == 0) {
+    state.memoryPolicy = mode;
+    state.nodeMask = mask;
+  }
+#endif
+  return state;
+}
+
+void ThreadTopology::apply(Role role) const {
+  const Placement &target = placement(role);
+  if (target.empty()) {
+#ifdef __linux__
+    if (role != Role::Io && !io.empty()) {
+      if (!inherited.cpus.empty()) {
+        pinCurrentThread(inherited.cpus);
+      }
+      syscall(SYS_set_mempolicy, inherited.memoryPolicy,
+              inherited.nodeMask != 0 ? &inherited.nodeMask : nullptr,
+              inherited.nodeMask != 0 ? MaxNodes : 0);
+    }
+#endif
+    return;
+  }
+#ifdef __linux__
+  int result = target.cpus.empty() ? 0 : pinCurrentThread(target.cpus);
+  if (result != 0) {
+    std::cerr << "Warning: could not pin thread to CPUs "
+              << formatCpus(target.cpus) << ": " << std::strerror(result)
+              << std::endl;
+  }
+  if (target.numaNode >= 0 && !preferNode(target.numaNode)) {
+    std::cerr << "Warning: could not prefer NUMA node " << target.numaNode
+              << ": " << std::strerror(errno) << std::endl;
+  }
+#else
+  std::cerr << "Warning: thread topology is only supported on Linux"
+            << std::endl;
+#endif
+}
+
+std::string ThreadTopology::describe() const {
+  return "io " + io.describe() + "; workers " + workers.describe() +
+         "; playout " + playout.describe();
+}
+
+void ThreadTopology::runBenchmark(std::ostream &out, size_t bytes) const {
+  int nodes = nodeCount();
+  out << "NUMA nodes: " << nodes << std::endl;
+  for (int node = 0; node < nodes; ++node) {
+    out << "  node " << node << ": CPUs " << formatCpus(cpusOfNode(node))
+        << std::endl;
+  }
+
+  // Reading frames from memory on another node is the cost a stage pays
+  // when its buffers were allocated by a thread on the wrong socket.
+  out << "Frame copy throughput (MB/s), memory node x CPU node:" << std::endl;
+  out << std::setw(10) << "memory";
+  for (int cpuNode = 0; cpuNode < nodes; ++cpuNode) {
+    out << std::setw(12) << ("cpu" + std::to_string(cpuNode));
+  }
+  out << std::endl;
+  for (int memoryNode = 0; memoryNode < nodes; ++memoryNode) {
+    out << std::setw(10) << ("node" + std::to_string(memoryNode));
+    char *buffer = allocateOnNode(bytes, memoryNode);
+    for (int cpuNode = 0; cpuNode < nodes; ++cpuNode) {
+      double throughput = 0;
+      std::thread reader([&]() {
+        pinCurrentThread(cpusOfNode(cpuNode));
+        copyMBps(buffer, bytes); // warm caches and TLB
+        throughput = copyMBps(buffer, bytes);
+      });
+      reader.join();
+      out << std::setw(12) << std::fixed << std::setprecision(0)
+          << throughput;
+    }
+    out << std::endl;
+    release(buffer, bytes);
+  }
+
+  // Hand-off latency between the stages that pass frames to each other.
+  struct Link {
+    const char *name;
+    const Placement &from;
+    const Placement &to;
+  };
+  auto cpusOf = [](const Placement &placement) {
+    return placement.cpus.empty() ? cpusOfNode(0) : placement.cpus;
+  };
+  for (const Link &link : {Link{"io -> workers", io, workers},
+                           Link{"io -> playout", io, playout}}) {
+    if (link.to.empty()) {
+      continue; // stage not placed
+    }
+    auto roundTrip = pingPong(cpusOf(link.from), cpusOf(link.to), 20000);
+    out << "Hand-off " << link.name << " (" << link.from.describe() << " -> "
+        << link.to.describe() << "): " << roundTrip.count() / 2
+        << " ns one way" << std::endl;
+  }
+}
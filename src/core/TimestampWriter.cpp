@@ -6,6 +6,7 @@
 #include <sstream>
 #include <chrono>
 #include "DataUnit.hpp"
+#include "Trace.hpp"
 
 TimestampWriter::TimestampWriter(const std::string &filename)
     : filename_(filename) {
@@ -22,17 +23,21 @@ void TimestampWriter::open(const std::string &filename) {
 }
 
 void TimestampWriter::write(const DataUnit &dataUnit) {
+  write(dataUnit, std::chrono::system_clock::now());
+}
+
+void TimestampWriter::write(const DataUnit &dataUnit,
+                            std::chrono::system_clock::time_point timestamp) {
+  VT_TRACE_SCOPE("TimestampWriter::write");
   if (file_.is_open()) {
-    // Generate timestamp
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                  now.time_since_epoch()) %
-              1000;
+    auto time_t = std::chrono::system_clock::to_time_t(timestamp);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                  timestamp.time_since_epoch()) %
+              1000000;
 
     std::stringstream ss;
     ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    ss << "." << std::setfill('0') << std::setw(3) << ms.count();
+    ss << "." << std::setfill('0') << std::setw(6) << us.count();
     ss << " - Video Unit: " << (Constants::HeaderSizeBytes + dataUnit.length)
        << " bytes (length: " << dataUnit.length << ")" << std::endl;
 
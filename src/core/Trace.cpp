@@ -0,0 +1,150 @@
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include <pthread.h>
+
+TraceBuffer::TraceBuffer(uint32_t threadId, std::string threadName)
+    : threadId_(threadId), threadName_(std::move(threadName)) {}
+
+void TraceBuffer::record(const char *name, uint64_t startNs,
+                         uint64_t durationNs, char phase) {
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  Slot &slot = slots_[head & (Capacity - 1)];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.startNs.store(startNs, std::memory_order_relaxed);
+  slot.durationNs.store(durationNs, std::memory_order_relaxed);
+  slot.phase.store(phase, std::memory_order_relaxed);
+  head_.store(head + 1, std::memory_order_release);
+}
+
+std::vector<TraceBuffer::Event> TraceBuffer::snapshot() const {
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t first = head > Capacity ? head - Capacity : 0;
+
+  std::vector<Event> events;
+  events.reserve(head - first);
+  for (uint64_t i = first; i < head; ++i) {
+    const Slot &slot = slots_[i & (Capacity - 1)];
+    events.push_back({slot.name.load(std::memory_order_relaxed),
+                      slot.startNs.load(std::memory_order_relaxed),
+                      slot.durationNs.load(std::memory_order_relaxed),
+                      slot.phase.load(std::memory_order_relaxed)});
+  }
+
+  // The owner may have lapped the oldest slots while they were copied. The
+  // slot at headAfter may be half written already, so it counts as lapped.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t headAfter = head_.load(std::memory_order_relaxed);
+  uint64_t firstIntact =
+      headAfter + 1 > Capacity ? headAfter + 1 - Capacity : 0;
+  if (firstIntact > first) {
+    size_t overwritten = static_cast<size_t>(
+        std::min<uint64_t>(firstIntact - first, events.size()));
+    events.erase(events.begin(), events.begin() + overwritten);
+  }
+  return events;
+}
+
+Tracer &Tracer::instance() {
+  static Tracer tracer;
+  return tracer;
+}
+
+uint64_t Tracer::nowNs() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+TraceBuffer &Tracer::threadBuffer() {
+  // Buffers outlive their threads so a late dump still sees their events.
+  thread_local TraceBuffer *buffer = nullptr;
+  if (buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto threadId = static_cast<uint32_t>(buffers_.size() + 1);
+    buffers_.push_back(std::make_unique<TraceBuffer>(
+        threadId, "thread " + std::to_string(threadId)));
+    buffer = buffers_.back().get();
+  }
+  return *buffer;
+}
+
+void Tracer::setThreadName(const std::string &name) {
+  auto &buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffer.setThreadName(name);
+}
+
+void Tracer::record(const char *name, uint64_t startNs, uint64_t durationNs,
+                    char phase) {
+  threadBuffer().record(name, startNs, durationNs, phase);
+}
+
+void Tracer::writeChromeTrace(std::ostream &out) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&]() -> std::ostream & {
+    out << (first ? "\n" : ",\n");
+    first = false;
+    return out;
+  };
+
+  out << std::fixed << std::setprecision(3);
+  for (const auto &buffer : buffers_) {
+    separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                << "\"tid\":" << buffer->getThreadId()
+                << ",\"args\":{\"name\":\"" << buffer->getThreadName()
+                << "\"}}";
+    for (const auto &event : buffer->snapshot()) {
+      // Chrome trace timestamps are in microseconds.
+      separator() << "{\"name\":\"" << event.name << "\",\"ph\":\""
+                  << event.phase << "\",\"pid\":1,\"tid\":"
+                  << buffer->getThreadId()
+                  << ",\"ts\":" << event.startNs / 1000.0;
+      if (event.phase == 'X') {
+        out << ",\"dur\":" << event.durationNs / 1000.0;
+      }
+      out << "}";
+    }
+  }
+  out << "\n]}\n";
+}
+
+bool Tracer::writeChromeTrace(const std::string &filename) const {
+  std::ofstream out(filename, std::ios::trunc);
+  if (!out.is_open()) {
+    return false;
+  }
+  writeChromeTrace(out);
+  return static_cast<bool>(out.flush());
+}
+
+void Tracer::dumpOnSignal(int signal, const std::string &filename) {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, signal);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  std::thread([this, signals, filename]() {
+    for (;;) {
+      int received = 0;
+      if (sigwait(&signals, &received) != 0) {
+        return;
+      }
+      if (writeChromeTrace(filename)) {
+        std::cout << "Trace snapshot written to " + filename << std::endl;
+      } else {
+        std::cerr << "Could not write trace snapshot " + filename << std::endl;
+      }
+    }
+  }).detach();
+}
@@ -0,0 +1,132 @@
+#include "TuningProfile.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/net_tstamp.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+#ifdef __linux__
+void setSocketOption(int fd, int level, int option, int value,
+                     const char *optionName) {
+  if (setsockopt(fd, level, option, &value, sizeof(value)) != 0) {
+    std::cerr << "Warning: could not set " << optionName << ": "
+              << std::strerror(errno) << std::endl;
+  }
+}
+#endif
+} // namespace
+
+TuningProfile TuningProfile::fromName(const std::string &name) {
+  TuningProfile profile;
+  profile.name = name;
+  if (name == "default") {
+    return profile;
+  }
+  if (name == "latency") {
+    profile.busyPollMicros = 50;
+    profile.quickAck = true;
+    profile.kernelTimestamps = true;
+    profile.fifoPriority = 10;
+    return profile;
+  }
+  if (name == "throughput") {
+    profile.sendBufferBytes = 4 * 1024 * 1024;
+    profile.receiveBufferBytes = 4 * 1024 * 1024;
+    profile.zeroCopy = true;
+    return profile;
+  }
+  throw std::runtime_error("Unknown tuning profile: " + name +
+                           " (expected default, latency or throughput)");
+}
+
+void TuningProfile::applySocketOptions(
+    boost::asio::ip::tcp::socket &socket) const {
+  if (sendBufferBytes > 0) {
+    socket.set_option(
+        boost::asio::socket_base::send_buffer_size(sendBufferBytes));
+  }
+  if (receiveBufferBytes > 0) {
+    socket.set_option(
+        boost::asio::socket_base::receive_buffer_size(receiveBufferBytes));
+  }
+
+#ifdef __linux__
+  int fd = socket.native_handle();
+  if (busyPollMicros > 0) {
+    setSocketOption(fd, SOL_SOCKET, SO_BUSY_POLL, busyPollMicros,
+                    "SO_BUSY_POLL");
+  }
+  if (quickAck) {
+    setSocketOption(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+  }
+  if (zeroCopy) {
+    setSocketOption(fd, SOL_SOCKET, SO_ZEROCOPY, 1, "SO_ZEROCOPY");
+  }
+  if (kernelTimestamps) {
+    setSocketOption(fd, SOL_SOCKET, SO_TIMESTAMPING,
+                    SOF_TIMESTAMPING_RX_SOFTWARE |
+                        SOF_TIMESTAMPING_TX_SOFTWARE |
+                        SOF_TIMESTAMPING_SOFTWARE | SOF_TIMESTAMPING_OPT_ID |
+                        SOF_TIMESTAMPING_OPT_TSONLY,
+                    "SO_TIMESTAMPING");
+  }
+#else
+  if (busyPollMicros > 0 || quickAck || zeroCopy || kernelTimestamps) {
+    std::cerr << "Warning: busy-poll, quick-ack, zero-copy and kernel "
+                 "timestamps are only supported on Linux"
+              << std::endl;
+  }
+#endif
+}
+
+void TuningProfile::applyThreadOptions() const {
+#ifdef __linux__
+  if (cpuAffinity >= 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpuAffinity, &cpus);
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (result != 0) {
+      std::cerr << "Warning: could not pin I/O thread to CPU "
+                << cpuAffinity << ": " << std::strerror(result) << std::endl;
+    }
+  }
+  if (fifoPriority > 0) {
+    sched_param param{};
+    param.sched_priority = fifoPriority;
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+      std::cerr << "Warning: could not switch I/O thread to SCHED_FIFO: "
+                << std::strerror(result) << std::endl;
+    }
+  }
+#else
+  if (cpuAffinity >= 0 || fifoPriority > 0) {
+    std::cerr << "Warning: thread pinning and SCHED_FIFO are only supported "
+                 "on Linux"
+              << std::endl;
+  }
+#endif
+}
+
+void TuningProfile::rearmQuickAck(boost::asio::ip::tcp::socket &socket) const {
+#ifdef __linux__
+  if (quickAck) {
+    int value = 1;
+    setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_QUICKACK, &value,
+               sizeof(value));
+  }
+#else
+  (void)socket;
+#endif
+}
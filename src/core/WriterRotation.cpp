@@ -0,0 +1,27 @@
+#include "WriterRotation.hpp"
+#include "DataFile.hpp"
+#include "TimestampWriter.hpp"
+
+WriterRotation::WriterRotation() = default;
+
+WriterRotation::~WriterRotation() = default;
+
+void WriterRotation::request(
+    std::unique_ptr<IDataFile> videoDataWriter,
+    std::unique_ptr<ITimestampWriter> timestampWriter) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  nextVideoDataWriter_ = std::move(videoDataWriter);
+  nextTimestampWriter_ = std::move(timestampWriter);
+  pending_.store(true, std::memory_order_release);
+}
+
+void WriterRotation::apply(std::unique_ptr<IDataFile> &videoDataWriter,
+                           std::unique_ptr<ITimestampWriter> &timestampWriter) {
+  if (!pending_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  videoDataWriter = std::move(nextVideoDataWriter_);
+  timestampWriter = std::move(nextTimestampWriter_);
+  pending_.store(false, std::memory_order_relaxed);
+}
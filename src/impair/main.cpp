@@ -0,0 +1,86 @@
+#include <iostream>
+#include "ImpairmentProxy.hpp"
+
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> positional;
+  ImpairmentConfig config;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&arg](const std::string &flag) {
+        return arg.substr(flag.size());
+      };
+      if (arg.rfind("--delay-us=", 0) == 0) {
+        config.delay = std::chrono::microseconds(std::stol(value("--delay-us=")));
+      } else if (arg.rfind("--jitter-us=", 0) == 0) {
+        config.jitter =
+            std::chrono::microseconds(std::stol(value("--jitter-us=")));
+      } else if (arg.rfind("--bandwidth-kbps=", 0) == 0) {
+        config.bandwidthBytesPerSecond =
+            std::stoull(value("--bandwidth-kbps=")) * 1000 / 8;
+      } else if (arg.rfind("--segment=", 0) == 0) {
+        // <min>-<max> bytes per forwarded segment
+        std::string range = value("--segment=");
+        auto dash = range.find('-');
+        config.minSegmentBytes = std::stoul(range.substr(0, dash));
+        config.maxSegmentBytes = dash == std::string::npos
+                                     ? config.minSegmentBytes
+                                     : std::stoul(range.substr(dash + 1));
+      } else if (arg.rfind("--stall=", 0) == 0) {
+        // <probability per segment>:<milliseconds>
+        std::string stall = value("--stall=");
+        auto colon = stall.find(':');
+        config.stallProbability = std::stod(stall.substr(0, colon));
+        config.stallDuration = std::chrono::milliseconds(
+            colon == std::string::npos ? 100 : std::stol(stall.substr(colon + 1)));
+      } else if (arg.rfind("--buffer-bytes=", 0) == 0) {
+        config.bufferBytes = std::stoul(value("--buffer-bytes="));
+      } else if (arg.rfind("--seed=", 0) == 0) {
+        config.seed = static_cast<uint32_t>(std::stoul(value("--seed=")));
+      } else {
+        positional.push_back(arg);
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: invalid option: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+
+  if (positional.size() != 3) {
+    std::cerr << "Usage: " + std::string(argv[0]) +
+                     " <listen_port> <target_host> <target_port>"
+                     " [--delay-us=<n>] [--jitter-us=<n>]"
+                     " [--bandwidth-kbps=<n>] [--segment=<min>-<max>]"
+                     " [--stall=<probability>:<ms>] [--buffer-bytes=<n>]"
+                     " [--seed=<n>]"
+              << std::endl;
+    std::cerr << "Example: " + std::string(argv[0]) +
+                     " 8081 localhost 8080 --delay-us=20000 --jitter-us=5000"
+                     " --segment=1-64"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    ImpairmentProxy proxy(static_cast<uint16_t>(std::stoi(positional[0])),
+                          positional[1],
+                          static_cast<uint16_t>(std::stoi(positional[2])),
+                          config);
+    std::cout << "Impairment proxy listening on port " << proxy.getPort()
+              << ", forwarding to " << positional[1] << ":" << positional[2]
+              << " (seed " << config.seed << ")" << std::endl;
+    proxy.start();
+    proxy.wait();
+    std::cout << "Forwarded " << proxy.getBytesForwarded() << " bytes in "
+              << proxy.getSegmentsForwarded() << " segments, "
+              << proxy.getStalls() << " stalls" << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
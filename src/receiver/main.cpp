@@ -1,16 +1,134 @@
 #include <iostream>
 #include "AsioReceiver.hpp"
+#include "ShmReceiver.hpp"
 #include "DataFile.hpp"
 #include "TimestampWriter.hpp"
 #include "DataAcceptor.hpp"
+#include "FrameCipher.hpp"
+#include "JitterBuffer.hpp"
+#include "CutThroughAcceptor.hpp"
+#include "FrameSink.hpp"
+#include "JournaledDataFile.hpp"
 #include "DataUnitConverter.hpp"
+#include "TuningProfile.hpp"
+#include "StreamDemultiplexer.hpp"
+#include "Trace.hpp"
+#include "ThreadTopology.hpp"
+#include "ConfigFile.hpp"
+#include "ControlServer.hpp"
+
+#include <csignal>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <optional>
+#include <vector>
 
 int main(int argc, char *argv[]) {
   std::cout << "Video Transport Receiver" << std::endl;
 
-  if (argc != 3) {
+  std::vector<std::string> positional;
+  std::string profileName = "default";
+  int cpu = -1;
+  bool multiplexed = false;
+  std::string transport = "tcp";
+  std::string traceFile;
+  std::string keyFile;
+  std::string topologySpec;
+  bool benchmarkTopology = false;
+  std::optional<JitterBufferConfig> jitterBufferConfig;
+  size_t jitterCapacity = 0;
+  int socketBufferBytes = 0;
+  std::string durabilityName = "flush";
+  size_t commitFrames = JournaledDataFile::DefaultCommitFrames;
+  std::chrono::milliseconds commitInterval =
+      JournaledDataFile::DefaultCommitInterval;
+  std::string controlPath;
+  bool cutThrough = false;
+  std::vector<std::string> args;
+  try {
+    args = ConfigFile::expandArguments(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+  for (const auto &arg : args) {
+    if (arg.rfind("--profile=", 0) == 0) {
+      profileName = arg.substr(std::string("--profile=").size());
+    } else if (arg.rfind("--cpu=", 0) == 0) {
+      cpu = std::stoi(arg.substr(std::string("--cpu=").size()));
+    } else if (arg.rfind("--transport=", 0) == 0) {
+      transport = arg.substr(std::string("--transport=").size());
+    } else if (arg.rfind("--trace=", 0) == 0) {
+      traceFile = arg.substr(std::string("--trace=").size());
+    } else if (arg.rfind("--key-file=", 0) == 0) {
+      keyFile = arg.substr(std::string("--key-file=").size());
+    } else if (arg.rfind("--topology=", 0) == 0) {
+      topologySpec = arg.substr(std::string("--topology=").size());
+    } else if (arg == "--benchmark-topology") {
+      benchmarkTopology = true;
+    } else if (arg.rfind("--jitter-buffer=", 0) == 0) {
+      // <initial_ms>[:<max_ms>]
+      std::string delays = arg.substr(std::string("--jitter-buffer=").size());
+      JitterBufferConfig config;
+      config.initialDelay = std::chrono::milliseconds(std::stoi(delays));
+      auto colon = delays.find(':');
+      if (colon != std::string::npos) {
+        config.maxDelay =
+            std::chrono::milliseconds(std::stoi(delays.substr(colon + 1)));
+      }
+      jitterBufferConfig = config;
+    } else if (arg.rfind("--jitter-capacity=", 0) == 0) {
+      jitterCapacity =
+          std::stoul(arg.substr(std::string("--jitter-capacity=").size()));
+    } else if (arg.rfind("--socket-buffer-bytes=", 0) == 0) {
+      socketBufferBytes = std::stoi(
+          arg.substr(std::string("--socket-buffer-bytes=").size()));
+    } else if (arg.rfind("--durability=", 0) == 0) {
+      durabilityName = arg.substr(std::string("--durability=").size());
+    } else if (arg.rfind("--commit-frames=", 0) == 0) {
+      commitFrames =
+          std::stoul(arg.substr(std::string("--commit-frames=").size()));
+    } else if (arg.rfind("--commit-ms=", 0) == 0) {
+      commitInterval = std::chrono::milliseconds(
+          std::stol(arg.substr(std::string("--commit-ms=").size())));
+    } else if (arg.rfind("--control=", 0) == 0) {
+      controlPath = arg.substr(std::string("--control=").size());
+    } else if (arg == "--cut-through") {
+      cutThrough = true;
+    } else if (arg == "--multiplexed") {
+      multiplexed = true;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  ThreadTopology topology;
+  try {
+    topology = ThreadTopology::parse(topologySpec);
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+  if (benchmarkTopology) {
+    topology.runBenchmark(std::cout);
+    return 0;
+  }
+
+  if (positional.size() != 2) {
     std::cerr << "Usage: " + std::string(argv[0]) +
-                     " <output_file> <listening_port>"
+                     " <output_file> <listening_port> [--multiplexed]"
+                     " [--transport=tcp|shm]"
+                     " [--profile=default|latency|throughput] [--cpu=<n>]"
+                     " [--trace=<file>] [--key-file=<file>]"
+                     " [--jitter-buffer=<initial_ms>[:<max_ms>]]"
+                     " [--topology=<spec>] [--benchmark-topology]"
+                     " [--jitter-capacity=<frames>]"
+                     " [--socket-buffer-bytes=<n>]"
+                     " [--durability=buffered|flush|sync|journal]"
+                     " [--commit-frames=<n>] [--commit-ms=<ms>]"
+                     " [--control=<socket>] [--config=<file>]"
+                     " [--cut-through]"
               << std::endl;
     std::cerr << "Example: " + std::string(argv[0]) +
                      " received_video_data.bin 8080"
@@ -18,33 +136,297 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  std::string outputFile = argv[1];
-  uint16_t port = static_cast<uint16_t>(std::stoi(argv[2]));
+  std::string outputFile = positional[0];
+  uint16_t port = static_cast<uint16_t>(std::stoi(positional[1]));
+
+  if (!traceFile.empty()) {
+    if (!Tracer::Enabled) {
+      std::cerr << "Warning: tracing is compiled out, configure with "
+                   "-DVIDEO_TRANSPORT_TRACING=ON"
+                << std::endl;
+    } else {
+      // A live receiver dumps a snapshot on SIGUSR1 and a full trace on exit.
+      Tracer::instance().dumpOnSignal(SIGUSR1, traceFile);
+      Tracer::instance().setThreadName("receiver");
+      std::cout << "Tracing to " + traceFile << std::endl;
+    }
+  }
 
   try {
-    auto videoDataWriter =
-        std::make_unique<DataFile>(outputFile, DataFile::Mode::Write);
-    auto timestampWriter =
-        std::make_unique<TimestampWriter>(outputFile + "_timestamps.txt");
+    auto profile = TuningProfile::fromName(profileName);
+    if (cpu >= 0) {
+      profile.cpuAffinity = cpu;
+    }
+    if (socketBufferBytes > 0) {
+      profile.receiveBufferBytes = socketBufferBytes;
+      profile.sendBufferBytes = socketBufferBytes;
+    }
+    // A journaled capture buffers its writes and commits them periodically
+    // instead of flushing every data unit; see vt-recover.
+    bool journaled = durabilityName == "journal";
+    auto durability = journaled ? DataFile::Durability::Buffered
+                                : DataFile::durabilityFromName(durabilityName);
+    auto openOutput = [&](const std::string &file)
+        -> std::unique_ptr<IDataFile> {
+      if (journaled) {
+        return std::make_unique<JournaledDataFile>(
+            file, file + "_timestamps.txt", commitFrames, commitInterval);
+      }
+      return std::make_unique<DataFile>(file, DataFile::Mode::Write,
+                                        durability);
+    };
+    if (cutThrough && (!keyFile.empty() || jitterBufferConfig.has_value())) {
+      // Both need the whole unit: GCM authenticates it as one, and playout
+      // releases complete frames.
+      throw std::runtime_error(
+          "--cut-through cannot be combined with --key-file or "
+          "--jitter-buffer");
+    }
+    if (cutThrough && multiplexed) {
+      // The demultiplexer buffers whole units per stream, so nothing would
+      // be cut through.
+      throw std::runtime_error(
+          "--cut-through cannot be combined with --multiplexed");
+    }
+    if (jitterBufferConfig.has_value() && jitterCapacity > 0) {
+      jitterBufferConfig->capacity = jitterCapacity;
+    }
+    std::cout << "Tuning profile: " + profile.name << std::endl;
+    if (!topologySpec.empty()) {
+      // The main thread runs the io_context; pin it before any receive
+      // buffers are allocated so they come from its node. --cpu, applied
+      // when the connection is accepted, still wins.
+      topology.apply(ThreadTopology::Role::Io);
+      std::cout << "Thread topology: " + topology.describe() << std::endl;
+      if (jitterBufferConfig.has_value()) {
+        jitterBufferConfig->threadInit = [topology]() {
+          topology.apply(ThreadTopology::Role::Playout);
+        };
+      }
+    }
+
+    // With a key every stream has to arrive encrypted and authenticated.
+    std::optional<FrameCipher::Key> key;
+    if (!keyFile.empty()) {
+      if (transport != "tcp") {
+        throw std::runtime_error(
+            "Encryption is only supported over the tcp transport");
+      }
+      key = FrameCipher::loadKey(keyFile);
+      std::cout << "Decrypting with AES-256-GCM ("
+                << (FrameCipher::hardwareAccelerated() ? "AES-NI" : "software")
+                << ")" << std::endl;
+    }
+    // Every output stream, registered as it appears so the control socket
+    // can rotate it and report on it. Multiplexed streams are created on the
+    // I/O thread, hence the mutex.
+    struct Output {
+      std::string file;
+      IDataAcceptor *acceptor;
+      DataAcceptor *wholeFrames;      // null with --cut-through
+      CutThroughAcceptor *cutThrough; // null without --cut-through
+      FileFrameSink *frameSink;       // null without --cut-through
+      JitterBuffer *jitterBuffer;     // null without --jitter-buffer
+      size_t part = 0;
+    };
+    std::mutex outputsMutex;
+    std::vector<Output> outputs;
 
-    auto dataAcceptor = std::make_unique<DataAcceptor>(
-        std::move(videoDataWriter), std::move(timestampWriter));
+    // A jitter buffer in front of a stream makes its timestamp log record
+    // playout instead of arrival times.
+    auto makeAcceptor = [&](const std::string &file, uint16_t streamId)
+        -> std::unique_ptr<IDataAcceptor> {
+      if (cutThrough) {
+        auto frameSink = std::make_unique<FileFrameSink>(
+            openOutput(file),
+            std::make_unique<TimestampWriter>(file + "_timestamps.txt"));
+        Output output{file, nullptr, nullptr, nullptr, frameSink.get(),
+                      nullptr};
+        auto acceptor =
+            std::make_unique<CutThroughAcceptor>(std::move(frameSink));
+        output.acceptor = output.cutThrough = acceptor.get();
+        std::lock_guard<std::mutex> lock(outputsMutex);
+        outputs.push_back(output);
+        return acceptor;
+      }
+      auto acceptor = std::make_unique<DataAcceptor>(
+          openOutput(file),
+          std::make_unique<TimestampWriter>(file + "_timestamps.txt"));
+      if (key.has_value()) {
+        acceptor->setCipher(
+            std::make_unique<FrameCipher>(key.value(), streamId));
+      }
+      Output output{file, acceptor.get(), acceptor.get(), nullptr, nullptr,
+                    nullptr};
+      std::unique_ptr<IDataAcceptor> result = std::move(acceptor);
+      if (jitterBufferConfig.has_value()) {
+        auto jitterBuffer = std::make_unique<JitterBuffer>(
+            std::move(result), jitterBufferConfig.value());
+        output.jitterBuffer = jitterBuffer.get();
+        result = std::move(jitterBuffer);
+      }
+      std::lock_guard<std::mutex> lock(outputsMutex);
+      outputs.push_back(output);
+      return result;
+    };
 
-    auto receiver =
-        std::make_unique<AsioReceiver>(port, std::move(dataAcceptor));
+    std::unique_ptr<ControlServer> controlServer;
+    if (!controlPath.empty()) {
+      controlServer = std::make_unique<ControlServer>(controlPath);
+      controlServer->addCommand(
+          "rotate", "rotate  - continue every stream in <file>.part<n>",
+          [&](const std::vector<std::string> &) {
+            std::lock_guard<std::mutex> lock(outputsMutex);
+            std::string reply;
+            for (auto &output : outputs) {
+              std::string file =
+                  output.file + ".part" + std::to_string(++output.part);
+              auto dataFile = openOutput(file);
+              auto timestampWriter =
+                  std::make_unique<TimestampWriter>(file + "_timestamps.txt");
+              if (output.frameSink != nullptr) {
+                output.frameSink->rotate(std::move(dataFile),
+                                         std::move(timestampWriter));
+              } else {
+                output.wholeFrames->rotate(std::move(dataFile),
+                                           std::move(timestampWriter));
+              }
+              reply += "rotated to " + file + "\n";
+            }
+            return reply.empty() ? "no streams yet" : reply;
+          });
+      controlServer->addCommand(
+          "stats", "stats   - per-stream receive and jitter buffer counters",
+          [&](const std::vector<std::string> &) {
+            std::lock_guard<std::mutex> lock(outputsMutex);
+            std::stringstream reply;
+            for (const auto &output : outputs) {
+              reply << output.file << ": units "
+                    << output.acceptor->getDataUnitsReceived() << ", bytes "
+                    << output.acceptor->getTotalBytesReceived() << ", part "
+                    << output.part;
+              if (output.wholeFrames != nullptr) {
+                reply << ", compressed "
+                      << output.wholeFrames->getCompressedUnitsReceived()
+                      << ", encrypted "
+                      << output.wholeFrames->getEncryptedUnitsReceived();
+              }
+              if (output.jitterBuffer != nullptr) {
+                auto jitter = output.jitterBuffer->getStats();
+                reply << ", jitter buffer occupancy "
+                      << output.jitterBuffer->getOccupancy() << ", target "
+                      << jitter.targetDelay.count() << " us, late "
+                      << jitter.lateFrames << ", underruns "
+                      << jitter.underruns;
+              }
+              reply << std::endl;
+            }
+            return reply.str().empty() ? "no streams yet" : reply.str();
+          });
+      controlServer->start();
+      std::cout << "Control socket: " + controlPath << std::endl;
+    }
 
-    std::cout << "Receiver started. Waiting for connections..." << std::endl;
+    // The receiver owns the acceptors, so everything that reaches them has
+    // to finish before it goes out of scope.
+    std::string outputStats;
+    StreamDemultiplexer *demultiplexer = nullptr;
+    auto finishOutputs = [&]() {
+      if (controlServer) {
+        controlServer->stop();
+      }
+      std::stringstream streamStats;
+      if (demultiplexer != nullptr) {
+        streamStats << std::endl
+                    << "Streams received: " << demultiplexer->getStreamCount();
+      }
+      for (size_t i = 0; i < outputs.size(); ++i) {
+        if (outputs[i].cutThrough != nullptr) {
+          const auto &cutThroughStats = outputs[i].cutThrough->getStats();
+          streamStats << std::endl
+                      << "Cut-through " << i << ": " << cutThroughStats.frames
+                      << " frames in " << cutThroughStats.chunks
+                      << " chunks (" << std::fixed << std::setprecision(2)
+                      << cutThroughStats.chunksPerFrame()
+                      << " per frame), written from "
+                      << cutThroughStats.averageLeadTime().count()
+                      << " us before completion on average";
+        }
+        if (outputs[i].jitterBuffer == nullptr) {
+          continue;
+        }
+        outputs[i].jitterBuffer->drain();
+        auto jitter = outputs[i].jitterBuffer->getStats();
+        streamStats
+            << std::endl
+            << "Jitter buffer " << i << ": " << jitter.framesReleased
+            << " frames played out, target delay " << std::fixed
+            << std::setprecision(1) << jitter.targetDelay.count() / 1000.0
+            << " ms, jitter " << jitter.jitter.count() / 1000.0
+            << " ms, occupancy avg " << jitter.averageOccupancy() << " max "
+            << jitter.maxOccupancy << ", late " << jitter.lateFrames
+            << ", underruns " << jitter.underruns << ", overflows "
+            << jitter.overflows << ", lost " << jitter.lostFrames;
+        if (!jitter.error.empty()) {
+          streamStats << ", playout stopped: " << jitter.error;
+        }
+      }
+      outputStats = streamStats.str();
+    };
 
-    receiver->start();
+    std::unique_ptr<IDataAcceptor> dataAcceptor;
+    if (multiplexed) {
+      auto streamDemultiplexer = std::make_unique<StreamDemultiplexer>(
+          [outputFile, makeAcceptor](
+              uint16_t streamId) -> std::unique_ptr<IDataAcceptor> {
+            return makeAcceptor(outputFile + "." + std::to_string(streamId),
+                                streamId);
+          });
+      demultiplexer = streamDemultiplexer.get();
+      dataAcceptor = std::move(streamDemultiplexer);
+    } else {
+      dataAcceptor = makeAcceptor(outputFile, 0);
+    }
+
+    size_t dataUnitsReceived = 0;
+    size_t totalBytesReceived = 0;
+    if (transport == "shm") {
+      // Both sides derive the segment name from the port number.
+      auto receiver = std::make_unique<ShmReceiver>(
+          "/video_transport_" + std::to_string(port), std::move(dataAcceptor));
+
+      std::cout << "Receiver started. Waiting for data..." << std::endl;
+
+      receiver->start();
+      finishOutputs();
+      dataUnitsReceived = receiver->getDataUnitsReceived();
+      totalBytesReceived = receiver->getTotalBytesReceived();
+    } else if (transport == "tcp") {
+      auto receiver = std::make_unique<AsioReceiver>(
+          port, std::move(dataAcceptor), profile);
+
+      std::cout << "Receiver started. Waiting for connections..." << std::endl;
+
+      receiver->start();
+      finishOutputs();
+      dataUnitsReceived = receiver->getDataUnitsReceived();
+      totalBytesReceived = receiver->getTotalBytesReceived();
+    } else {
+      throw std::runtime_error("Unknown transport: " + transport);
+    }
 
     std::stringstream stats;
-    stats << "Total data units received: " << receiver->getDataUnitsReceived()
-          << std::endl;
-    stats << "Total bytes received: " << receiver->getTotalBytesReceived();
+    stats << "Total data units received: " << dataUnitsReceived << std::endl;
+    stats << "Total bytes received: " << totalBytesReceived;
+    stats << outputStats;
     std::cout << "\n=== RECEIVER STATISTICS ===" << std::endl;
     std::cout << stats.str() << std::endl;
     std::cout << "===========================" << std::endl;
 
+    if (!traceFile.empty() && Tracer::Enabled) {
+      Tracer::instance().writeChromeTrace(traceFile);
+    }
+
   } catch (const std::exception &e) {
     std::cerr << "Error: " + std::string(e.what()) << std::endl;
     return 1;
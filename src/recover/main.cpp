@@ -0,0 +1,78 @@
+#include <iostream>
+#include "CaptureJournal.hpp"
+
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> positional;
+  std::string timestampFile;
+  bool dryRun = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--timestamps=", 0) == 0) {
+      timestampFile = arg.substr(std::string("--timestamps=").size());
+    } else if (arg == "--dry-run") {
+      dryRun = true;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  if (positional.size() != 1) {
+    std::cerr << "Usage: " + std::string(argv[0]) +
+                     " <output_file> [--timestamps=<file>] [--dry-run]"
+              << std::endl;
+    std::cerr << "Example: " + std::string(argv[0]) + " received.bin"
+              << std::endl;
+    return 1;
+  }
+  std::string dataFile = positional.front();
+  if (timestampFile.empty()) {
+    timestampFile = dataFile + "_timestamps.txt";
+  }
+
+  try {
+    auto recovery = CaptureJournal::recover(dataFile, timestampFile, dryRun);
+
+    std::stringstream report;
+    if (recovery.commit.has_value()) {
+      auto committedAt =
+          std::chrono::system_clock::to_time_t(recovery.commit->committedAt);
+      report << "Last commit: #" << recovery.commit->sequence << " at "
+             << std::put_time(std::localtime(&committedAt),
+                              "%Y-%m-%d %H:%M:%S")
+             << ", " << recovery.commit->frames << " data units, "
+             << recovery.commit->dataBytes << " bytes, "
+             << recovery.commit->timestampBytes << " timestamp log bytes"
+             << std::endl;
+    } else {
+      report << "No valid commit: nothing of the capture is known to be "
+                "complete"
+             << std::endl;
+    }
+    uint64_t dataBytes = recovery.commit ? recovery.commit->dataBytes : 0;
+    uint64_t timestampBytes =
+        recovery.commit ? recovery.commit->timestampBytes : 0;
+    report << dataFile << ": " << recovery.dataBytesFound << " -> "
+           << dataBytes << " bytes" << std::endl;
+    report << timestampFile << ": " << recovery.timestampBytesFound << " -> "
+           << timestampBytes << " bytes" << std::endl;
+    if (!recovery.truncated) {
+      report << "Capture is consistent, nothing to cut";
+    } else if (dryRun) {
+      report << "Dry run, nothing truncated";
+    } else {
+      report << "Truncated to the last commit";
+    }
+    std::cout << report.str() << std::endl;
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
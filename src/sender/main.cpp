@@ -1,20 +1,138 @@
 #include <iostream>
 #include "AsioSender.hpp"
+#include "ShmSender.hpp"
 #include "DataProvider.hpp"
+#include "CompressionStage.hpp"
+#include "Codec.hpp"
+#include "EncryptionStage.hpp"
+#include "FrameCipher.hpp"
+#include "WorkerPool.hpp"
 #include "DataFile.hpp"
+#include "IndexedDataFile.hpp"
 #include "DataUnitConverter.hpp"
+#include "TimestampWriter.hpp"
+#include "TuningProfile.hpp"
+#include "Trace.hpp"
+#include "ThreadTopology.hpp"
+#include "ConfigFile.hpp"
+#include "ControlServer.hpp"
 
+#include <optional>
 #include <vector>
 #include <stdexcept>
 #include <chrono>
 #include <functional>
+#include <iomanip>
+#include <sstream>
 
 int main(int argc, char *argv[]) {
+  auto launchedAt = std::chrono::steady_clock::now();
   std::cout << "Video Transport Sender" << std::endl;
 
-  if (argc != 4) {
+  std::vector<std::string> positional;
+  std::string profileName = "default";
+  std::string txTimestampsFile;
+  int cpu = -1;
+  bool multiplexed = false;
+  std::string transport = "tcp";
+  size_t queueDepth = 0;
+  int maxLatencyMs = 0;
+  size_t warmFrames = 0;
+  std::string traceFile;
+  std::vector<std::string> codecNames = {"none"};
+  unsigned compressionThreads = 0;
+  std::string keyFile;
+  std::string topologySpec;
+  bool benchmarkTopology = false;
+  std::chrono::microseconds interval = std::chrono::milliseconds(10);
+  int socketBufferBytes = 0;
+  std::string controlPath;
+  std::vector<std::string> args;
+  try {
+    args = ConfigFile::expandArguments(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+  for (const auto &arg : args) {
+    if (arg.rfind("--profile=", 0) == 0) {
+      profileName = arg.substr(std::string("--profile=").size());
+    } else if (arg.rfind("--cpu=", 0) == 0) {
+      cpu = std::stoi(arg.substr(std::string("--cpu=").size()));
+    } else if (arg.rfind("--tx-timestamps=", 0) == 0) {
+      txTimestampsFile = arg.substr(std::string("--tx-timestamps=").size());
+    } else if (arg.rfind("--transport=", 0) == 0) {
+      transport = arg.substr(std::string("--transport=").size());
+    } else if (arg.rfind("--queue-depth=", 0) == 0) {
+      queueDepth = std::stoul(arg.substr(std::string("--queue-depth=").size()));
+    } else if (arg.rfind("--max-latency-ms=", 0) == 0) {
+      maxLatencyMs =
+          std::stoi(arg.substr(std::string("--max-latency-ms=").size()));
+    } else if (arg.rfind("--warm-frames=", 0) == 0) {
+      warmFrames = std::stoul(arg.substr(std::string("--warm-frames=").size()));
+    } else if (arg.rfind("--codec=", 0) == 0) {
+      // One codec per stream in input order; the last one repeats.
+      std::stringstream names(arg.substr(std::string("--codec=").size()));
+      codecNames.clear();
+      for (std::string name; std::getline(names, name, ',');) {
+        codecNames.push_back(name);
+      }
+    } else if (arg.rfind("--compression-threads=", 0) == 0) {
+      compressionThreads = static_cast<unsigned>(std::stoul(
+          arg.substr(std::string("--compression-threads=").size())));
+    } else if (arg.rfind("--trace=", 0) == 0) {
+      traceFile = arg.substr(std::string("--trace=").size());
+    } else if (arg.rfind("--key-file=", 0) == 0) {
+      keyFile = arg.substr(std::string("--key-file=").size());
+    } else if (arg.rfind("--topology=", 0) == 0) {
+      topologySpec = arg.substr(std::string("--topology=").size());
+    } else if (arg.rfind("--interval-ms=", 0) == 0) {
+      interval = std::chrono::microseconds(static_cast<int64_t>(
+          std::stod(arg.substr(std::string("--interval-ms=").size())) *
+          1000));
+      if (interval.count() <= 0) {
+        std::cerr << "Error: --interval-ms must be positive" << std::endl;
+        return 1;
+      }
+    } else if (arg.rfind("--socket-buffer-bytes=", 0) == 0) {
+      socketBufferBytes = std::stoi(
+          arg.substr(std::string("--socket-buffer-bytes=").size()));
+    } else if (arg.rfind("--control=", 0) == 0) {
+      controlPath = arg.substr(std::string("--control=").size());
+    } else if (arg == "--benchmark-topology") {
+      benchmarkTopology = true;
+    } else if (arg == "--multiplexed") {
+      multiplexed = true;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  ThreadTopology topology;
+  try {
+    topology = ThreadTopology::parse(topologySpec);
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " + std::string(e.what()) << std::endl;
+    return 1;
+  }
+  if (benchmarkTopology) {
+    topology.runBenchmark(std::cout);
+    return 0;
+  }
+
+  if (positional.size() < 3) {
     std::cerr << "Usage: " + std::string(argv[0]) +
-                     " <input_file> <destination_ip> <port>"
+                     " <input_file> [<input_file>...] <destination_ip> <port>"
+                     " [--multiplexed] [--transport=tcp|shm]"
+                     " [--profile=default|latency|throughput] [--cpu=<n>]"
+                     " [--tx-timestamps=<file>]"
+                     " [--queue-depth=<frames>] [--max-latency-ms=<ms>]"
+                     " [--warm-frames=<n>] [--trace=<file>]"
+                     " [--codec=none|lz4|deflate[,...]]"
+                     " [--compression-threads=<n>] [--key-file=<file>]"
+                     " [--topology=<spec>] [--benchmark-topology]"
+                     " [--interval-ms=<ms>] [--socket-buffer-bytes=<n>]"
+                     " [--control=<socket>] [--config=<file>]"
               << std::endl;
     std::cerr << "Example: " + std::string(argv[0]) +
                      " resources/front_0.bin 127.0.0.1 8080"
@@ -22,17 +140,237 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  std::string filename = argv[1];
-  std::string destinationIp = argv[2];
-  uint16_t destinationPort = static_cast<uint16_t>(std::stoi(argv[3]));
+  std::vector<std::string> filenames(positional.begin(), positional.end() - 2);
+  std::string destinationIp = positional[positional.size() - 2];
+  uint16_t destinationPort =
+      static_cast<uint16_t>(std::stoi(positional.back()));
+  multiplexed = multiplexed || filenames.size() > 1;
+
+  if (!traceFile.empty() && !Tracer::Enabled) {
+    std::cerr << "Warning: tracing is compiled out, configure with "
+                 "-DVIDEO_TRANSPORT_TRACING=ON"
+              << std::endl;
+  } else if (!traceFile.empty()) {
+    Tracer::instance().setThreadName("sender");
+  }
+  auto writeTrace = [&traceFile]() {
+    if (!traceFile.empty() && Tracer::Enabled) {
+      Tracer::instance().writeChromeTrace(traceFile);
+    }
+  };
 
   try {
-    auto dataFile = std::make_unique<DataFile>(filename);
-    auto dataProvider = std::make_unique<DataProvider>(std::move(dataFile));
-    auto socket = std::make_unique<AsioSender>(destinationIp, destinationPort,
-                                               std::move(dataProvider));
+    auto profile = TuningProfile::fromName(profileName);
+    if (cpu >= 0) {
+      profile.cpuAffinity = cpu;
+    }
+    if (!txTimestampsFile.empty()) {
+      profile.kernelTimestamps = true;
+    }
+    if (socketBufferBytes > 0) {
+      profile.sendBufferBytes = socketBufferBytes;
+      profile.receiveBufferBytes = socketBufferBytes;
+    }
+    std::cout << "Tuning profile: " + profile.name << std::endl;
+    if (!topologySpec.empty()) {
+      // The main thread runs the io_context; pin it before any frame
+      // buffers are allocated so they come from its node. --cpu, applied
+      // when the transport starts, still wins.
+      topology.apply(ThreadTopology::Role::Io);
+      std::cout << "Thread topology: " + topology.describe() << std::endl;
+    }
+
+    // With a warm start the input is memory-mapped through a frame index and
+    // its first frames are faulted in before the transport clock starts.
+    size_t prefaultedBytes = 0;
+    auto openFile = [&](const std::string &filename)
+        -> std::unique_ptr<IDataFile> {
+      if (warmFrames == 0) {
+        return std::make_unique<DataFile>(filename);
+      }
+      auto dataFile = std::make_unique<IndexedDataFile>(filename);
+      std::cout << "Frame index "
+                << (dataFile->indexWasLoaded() ? "loaded" : "built") << ": "
+                << dataFile->getFrameCount() << " frames in " << filename
+                << std::endl;
+      prefaultedBytes += dataFile->prefault(warmFrames);
+      return dataFile;
+    };
+
+    if (!controlPath.empty() && transport != "tcp") {
+      throw std::runtime_error(
+          "The control socket is only supported over the tcp transport");
+    }
+
+    std::optional<FrameCipher::Key> key;
+    if (!keyFile.empty()) {
+      if (transport != "tcp") {
+        throw std::runtime_error(
+            "Encryption is only supported over the tcp transport");
+      }
+      key = FrameCipher::loadKey(keyFile);
+    }
+
+    // Streams with a codec get a compression stage running on a shared
+    // worker pool ahead of the pacing clock; encryption comes last.
+    std::shared_ptr<WorkerPool> compressionPool;
+    std::vector<CompressionStage *> compressionStages;
+    std::vector<EncryptionStage *> encryptionStages;
+    size_t streamCount = 0;
+    auto openInput = [&](const std::string &filename)
+        -> std::unique_ptr<IDataProvider> {
+      std::unique_ptr<IDataProvider> dataProvider =
+          std::make_unique<DataProvider>(openFile(filename));
+      auto streamId = static_cast<uint16_t>(streamCount);
+      const auto &codecName =
+          codecNames[std::min(streamCount++, codecNames.size() - 1)];
+      if (auto codec = ICodec::fromName(codecName)) {
+        if (!compressionPool) {
+          compressionPool = std::make_shared<WorkerPool>(
+              compressionThreads, [topology]() {
+                topology.apply(ThreadTopology::Role::Workers);
+              });
+        }
+        auto stage = std::make_unique<CompressionStage>(
+            std::move(dataProvider), std::move(codec), compressionPool);
+        compressionStages.push_back(stage.get());
+        dataProvider = std::move(stage);
+      }
+      if (key.has_value()) {
+        auto stage = std::make_unique<EncryptionStage>(
+            std::move(dataProvider),
+            std::make_unique<FrameCipher>(key.value(), streamId));
+        encryptionStages.push_back(stage.get());
+        dataProvider = std::move(stage);
+      }
+      return dataProvider;
+    };
+    auto reportStages = [&]() {
+      for (size_t i = 0; i < compressionStages.size(); ++i) {
+        const auto &stats = compressionStages[i]->getStats();
+        std::cout << "Compression (" << compressionStages[i]->getCodec().getName()
+                  << "): " << stats.compressedFrames << "/" << stats.frames
+                  << " frames compressed, " << stats.attemptedFrames
+                  << " attempted, " << stats.inputBytes << " -> "
+                  << stats.outputBytes << " bytes, ratio " << std::fixed
+                  << std::setprecision(2) << stats.ratio() << ", "
+                  << stats.throughputMBps() << " MB/s" << std::endl;
+      }
+      for (auto *stage : encryptionStages) {
+        const auto &stats = stage->getStats();
+        std::cout << "Encryption (AES-256-GCM, "
+                  << (FrameCipher::hardwareAccelerated() ? "AES-NI"
+                                                         : "software")
+                  << "): " << stats.frames << " frames, " << stats.plainBytes
+                  << " bytes, +" << stats.overheadBytes << " bytes, "
+                  << std::fixed << std::setprecision(2)
+                  << stats.throughputMBps() << " MB/s, "
+                  << stats.microsecondsPerFrame() << " us/frame" << std::endl;
+      }
+    };
+
+    if (transport == "shm") {
+      if (multiplexed) {
+        throw std::runtime_error(
+            "Multiplexing is only supported over the tcp transport");
+      }
+      // Both sides derive the segment name from the port number.
+      ShmSender sender("/video_transport_" + std::to_string(destinationPort),
+                       openInput(filenames.front()));
+      sender.startTransport(interval);
+      reportStages();
+      writeTrace();
+      return 0;
+    }
+    if (transport != "tcp") {
+      throw std::runtime_error("Unknown transport: " + transport);
+    }
+
+    std::unique_ptr<AsioSender> socket;
+    if (multiplexed) {
+      std::vector<std::unique_ptr<IDataProvider>> dataProviders;
+      for (const auto &filename : filenames) {
+        dataProviders.push_back(openInput(filename));
+      }
+      std::cout << "Multiplexing " << dataProviders.size()
+                << " streams over one connection" << std::endl;
+      socket = std::make_unique<AsioSender>(destinationIp, destinationPort,
+                                            std::move(dataProviders), profile);
+    } else {
+      socket = std::make_unique<AsioSender>(destinationIp, destinationPort,
+                                            openInput(filenames.front()),
+                                            profile);
+    }
+    socket->setQueuePolicy(queueDepth,
+                           std::chrono::milliseconds(maxLatencyMs));
+    if (!txTimestampsFile.empty()) {
+      socket->setTxTimestampWriter(
+          std::make_unique<TimestampWriter>(txTimestampsFile));
+    }
+
+    if (warmFrames > 0) {
+      size_t prefetched = socket->warmUp(warmFrames);
+      std::cout << "Warm start: " << prefetched << " frames prefetched, "
+                << prefaultedBytes << " bytes prefaulted" << std::endl;
+    }
+
+    std::unique_ptr<ControlServer> controlServer;
+    if (!controlPath.empty()) {
+      auto setInterval = [&socket](std::chrono::microseconds interval) {
+        if (interval.count() <= 0) {
+          throw std::runtime_error("Interval must be positive");
+        }
+        socket->setInterval(interval);
+        return "interval " + std::to_string(interval.count()) + " us";
+      };
+      controlServer = std::make_unique<ControlServer>(controlPath);
+      controlServer->addCommand(
+          "interval", "interval <ms>  - frame interval of every stream",
+          [setInterval](const std::vector<std::string> &args) {
+            if (args.size() != 1) {
+              throw std::runtime_error("usage: interval <ms>");
+            }
+            return setInterval(std::chrono::microseconds(
+                static_cast<int64_t>(std::stod(args[0]) * 1000)));
+          });
+      controlServer->addCommand(
+          "rate", "rate <fps>     - frame rate of every stream",
+          [setInterval](const std::vector<std::string> &args) {
+            if (args.size() != 1 || std::stod(args[0]) <= 0) {
+              throw std::runtime_error("usage: rate <fps>");
+            }
+            return setInterval(std::chrono::microseconds(
+                static_cast<int64_t>(1e6 / std::stod(args[0]))));
+          });
+      controlServer->addCommand(
+          "stats", "stats          - frames sent, dropped and queued",
+          [&socket](const std::vector<std::string> &) {
+            auto stats = socket->getStats();
+            return "sent " + std::to_string(stats.framesSent) + " frames, " +
+                   std::to_string(stats.bytesSent) + " bytes, dropped " +
+                   std::to_string(stats.droppedFrames) + " frames, " +
+                   std::to_string(stats.droppedBytes) + " bytes, queued " +
+                   std::to_string(stats.queuedFrames) + ", interval " +
+                   std::to_string(stats.interval.count()) + " us";
+          });
+      controlServer->start();
+      std::cout << "Control socket: " + controlPath << std::endl;
+    }
 
-    socket->startTransport(std::chrono::milliseconds(10));
+    auto clockStartedAt = std::chrono::steady_clock::now();
+    socket->startTransport(interval);
+    if (controlServer) {
+      controlServer->stop();
+    }
+    if (auto timeToFirstFrame = socket->getTimeToFirstFrame()) {
+      auto sinceLaunch = std::chrono::duration_cast<std::chrono::microseconds>(
+          clockStartedAt - launchedAt) + timeToFirstFrame.value();
+      std::cout << "Time to first frame: " << timeToFirstFrame->count()
+                << " us after transport start (" << sinceLaunch.count()
+                << " us after launch)" << std::endl;
+    }
+    reportStages();
+    writeTrace();
   } catch (const std::exception &e) {
     std::cerr << "Error: " + std::string(e.what()) << std::endl;
     return 1;
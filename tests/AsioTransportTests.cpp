@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include "AsioReceiver.hpp"
+#include "AsioSender.hpp"
+#include "Constants.hpp"
+#include "DataAcceptor.hpp"
+#include "DataFile.hpp"
+#include "DataProvider.hpp"
+#include "DataUnitConverter.hpp"
+#include "StreamDemultiplexer.hpp"
+#include "TimestampWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+// Hands out a few frames of a file, then fails like a broken input.
+class FailingDataProvider : public IDataProvider {
+public:
+  FailingDataProvider(const std::string &fileName, size_t framesBeforeFailure)
+      : provider_(std::make_unique<DataFile>(fileName)),
+        framesLeft_(framesBeforeFailure) {}
+
+  std::optional<std::vector<char>> getNextData() override {
+    if (framesLeft_ == 0) {
+      throw std::runtime_error("input failed");
+    }
+    framesLeft_--;
+    return provider_.getNextData();
+  }
+  size_t prefetch(size_t) override { return 0; }
+
+private:
+  DataProvider provider_;
+  size_t framesLeft_;
+};
+
+// Endless stream of maximum-size frames, to outrun a receiver that stalls.
+class EndlessDataProvider : public IDataProvider {
+public:
+  std::optional<std::vector<char>> getNextData() override {
+    size_t length = Constants::MaxPacketSize;
+    std::vector<char> frame(Constants::HeaderSizeBytes + length, 'x');
+    frame[0] = 0;
+    frame[1] = static_cast<char>((length >> 16) & 0xFF);
+    frame[2] = static_cast<char>((length >> 8) & 0xFF);
+    frame[3] = static_cast<char>(length & 0xFF);
+    return frame;
+  }
+  size_t prefetch(size_t) override { return 0; }
+};
+
+class AsioTransportTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    inputFileName_ = "../../resources/front_0.bin";
+    outputFileName_ = "asio_transport_test.bin";
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(outputFileName_);
+    std::filesystem::remove(outputFileName_ + "_timestamps.txt");
+  }
+
+  std::unique_ptr<AsioReceiver> makeReceiver() {
+    auto dataAcceptor = std::make_unique<DataAcceptor>(
+        std::make_unique<DataFile>(outputFileName_, DataFile::Mode::Write),
+        std::make_unique<TimestampWriter>(outputFileName_ + "_timestamps.txt"));
+    return std::make_unique<AsioReceiver>(0, std::move(dataAcceptor));
+  }
+
+  static std::vector<char> readFile(const std::string &fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+  }
+
+  std::string inputFileName_;
+  std::string outputFileName_;
+};
+
+TEST_F(AsioTransportTest, TransfersFileOverLoopback) {
+  auto receiver = makeReceiver();
+  std::thread receiverThread([&receiver]() { receiver->start(); });
+
+  {
+    AsioSender sender("127.0.0.1", receiver->getPort(),
+                      std::make_unique<DataProvider>(
+                          std::make_unique<DataFile>(inputFileName_)));
+    sender.startTransport(std::chrono::milliseconds(1));
+  }
+  receiverThread.join();
+
+  EXPECT_EQ(receiver->getDataUnitsReceived(), 10);
+  receiver.reset();
+  EXPECT_EQ(readFile(outputFileName_), readFile(inputFileName_));
+}
+
+TEST_F(AsioTransportTest, StopCancelsPendingAccept) {
+  auto receiver = makeReceiver();
+  std::thread receiverThread([&receiver]() { receiver->start(); });
+
+  receiver->stop();
+  receiverThread.join();
+
+  EXPECT_EQ(receiver->getDataUnitsReceived(), 0);
+}
+
+TEST_F(AsioTransportTest, SetIntervalRepacesRunningTransfer) {
+  auto receiver = makeReceiver();
+  std::thread receiverThread([&receiver]() { receiver->start(); });
+
+  AsioSender::Stats stats;
+  std::chrono::steady_clock::duration elapsed;
+  {
+    AsioSender sender("127.0.0.1", receiver->getPort(),
+                      std::make_unique<DataProvider>(
+                          std::make_unique<DataFile>(inputFileName_)));
+    // At one frame per second the file would take ten seconds.
+    std::thread controlThread([&sender]() {
+      while (sender.getStats().framesSent == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      sender.setInterval(std::chrono::milliseconds(1));
+    });
+    auto startedAt = std::chrono::steady_clock::now();
+    sender.startTransport(std::chrono::seconds(1));
+    elapsed = std::chrono::steady_clock::now() - startedAt;
+    controlThread.join();
+    stats = sender.getStats();
+  }
+  receiverThread.join();
+
+  EXPECT_EQ(stats.framesSent, 10);
+  EXPECT_EQ(stats.droppedFrames, 0);
+  EXPECT_EQ(stats.interval, std::chrono::milliseconds(1));
+  EXPECT_LT(elapsed, std::chrono::seconds(5));
+  EXPECT_EQ(receiver->getDataUnitsReceived(), 10);
+}
+
+TEST_F(AsioTransportTest, FailedStreamDoesNotStallMultiplexedTransfer) {
+  auto demultiplexer = std::make_unique<StreamDemultiplexer>(
+      [this](uint16_t streamId) -> std::unique_ptr<IDataAcceptor> {
+        std::string file = outputFileName_ + "." + std::to_string(streamId);
+        return std::make_unique<DataAcceptor>(
+            std::make_unique<DataFile>(file, DataFile::Mode::Write),
+            std::make_unique<TimestampWriter>(file + "_timestamps.txt"));
+      });
+  auto *streamDemultiplexer = demultiplexer.get();
+  auto receiver = std::make_unique<AsioReceiver>(0, std::move(demultiplexer));
+  std::thread receiverThread([&receiver]() { receiver->start(); });
+
+  {
+    std::vector<std::unique_ptr<IDataProvider>> dataProviders;
+    dataProviders.push_back(std::make_unique<DataProvider>(
+        std::make_unique<DataFile>(inputFileName_)));
+    dataProviders.push_back(
+        std::make_unique<FailingDataProvider>(inputFileName_, 3));
+    AsioSender sender("127.0.0.1", receiver->getPort(),
+                      std::move(dataProviders));
+    // Returns only once every stream has finished.
+    sender.startTransport(std::chrono::milliseconds(1));
+  }
+  receiverThread.join();
+
+  ASSERT_EQ(streamDemultiplexer->getStreamCount(), 2u);
+  EXPECT_EQ(streamDemultiplexer->getStream(0)->getDataUnitsReceived(), 10u);
+  EXPECT_EQ(streamDemultiplexer->getStream(1)->getDataUnitsReceived(), 3u);
+  receiver.reset();
+  EXPECT_EQ(readFile(outputFileName_ + ".0"), readFile(inputFileName_));
+  for (const auto &suffix : {".0", ".1"}) {
+    std::filesystem::remove(outputFileName_ + suffix);
+    std::filesystem::remove(outputFileName_ + suffix + "_timestamps.txt");
+  }
+}
+
+TEST_F(AsioTransportTest, StalledReceiverDoesNotGrowTheDefaultQueue) {
+  boost::asio::io_context acceptorContext;
+  boost::asio::ip::tcp::acceptor acceptor(
+      acceptorContext,
+      boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(),
+                                     0));
+  AsioSender sender("127.0.0.1", acceptor.local_endpoint().port(),
+                    std::make_unique<EndlessDataProvider>());
+  // Accepted but never read, so the socket buffers fill and writes stall.
+  boost::asio::ip::tcp::socket stalled(acceptorContext);
+  acceptor.accept(stalled);
+
+  std::thread senderThread(
+      [&sender]() { sender.startTransport(std::chrono::microseconds(100)); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  auto stats = sender.getStats();
+  sender.stop();
+  senderThread.join();
+
+  EXPECT_GT(stats.framesSent, 0u);
+  EXPECT_LE(stats.queuedFrames, 1u);
+  EXPECT_EQ(stats.droppedFrames, 0u);
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "CaptureAnalyzer.hpp"
+#include "MappedFile.hpp"
+
+#include <string>
+
+class CaptureAnalyzerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    source_ = std::make_unique<MappedFile>("../../resources/front_0.bin");
+    copy_.assign(source_->data(), source_->data() + source_->size());
+  }
+
+  CaptureAnalyzer analyzer_{4};
+  std::unique_ptr<MappedFile> source_;
+  std::vector<char> copy_;
+};
+
+TEST_F(CaptureAnalyzerTest, IndexesWellFramedFile) {
+  auto framing = analyzer_.indexFrames(source_->data(), source_->size());
+
+  EXPECT_TRUE(framing.error.empty()) << framing.error;
+  EXPECT_EQ(framing.frames.size(), 10);
+  EXPECT_EQ(framing.validBytes, source_->size());
+  EXPECT_EQ(framing.frames[0].offset, 0);
+  EXPECT_EQ(framing.frames[0].length, 2);
+}
+
+TEST_F(CaptureAnalyzerTest, ReportsTruncatedFrame) {
+  auto framing = analyzer_.indexFrames(copy_.data(), copy_.size() - 1);
+
+  EXPECT_FALSE(framing.error.empty());
+  EXPECT_EQ(framing.frames.size(), 9);
+  EXPECT_LT(framing.validBytes, copy_.size());
+}
+
+TEST_F(CaptureAnalyzerTest, FindsFirstDivergentFrame) {
+  auto sourceFraming = analyzer_.indexFrames(source_->data(), source_->size());
+  auto identical = analyzer_.compareFrames(copy_.data(), sourceFraming,
+                                           source_->data(), sourceFraming);
+  EXPECT_TRUE(identical.identical);
+  EXPECT_EQ(analyzer_.checksum(copy_.data(), sourceFraming),
+            analyzer_.checksum(source_->data(), sourceFraming));
+
+  const auto &target = sourceFraming.frames[7];
+  copy_[target.offset + 4 + 3] ^= 0x55;
+  auto divergence = analyzer_.compareFrames(copy_.data(), sourceFraming,
+                                            source_->data(), sourceFraming);
+
+  EXPECT_FALSE(divergence.identical);
+  EXPECT_EQ(divergence.frameIndex, 7);
+  EXPECT_EQ(divergence.captureOffset, target.offset);
+  EXPECT_EQ(divergence.reason, "payload differs at byte 3");
+}
+
+TEST_F(CaptureAnalyzerTest, AnalyzesTimestampLog) {
+  std::string log =
+      "2025-08-04 22:21:30.000000 - Video Unit: 6 bytes (length: 2)\n"
+      "2025-08-04 22:21:30.010000 - Video Unit: 100 bytes (length: 96)\n"
+      "not a timestamp line\n"
+      "2025-08-04 22:21:30.021000 - Video Unit: 6 bytes (length: 2)\n"
+      "2025-08-04 22:21:30.061 - Video Unit: 4 bytes (length: 0)\n";
+
+  auto records = analyzer_.parseTimestampLog(log.data(), log.size());
+  ASSERT_EQ(records.size(), 4);
+  EXPECT_EQ(records[1].microseconds - records[0].microseconds, 10000);
+  EXPECT_EQ(records[3].microseconds - records[2].microseconds, 40000);
+  EXPECT_EQ(records[1].bytes, 100);
+
+  auto report = analyzer_.analyzeTiming(records, std::chrono::milliseconds(10),
+                                        std::chrono::milliseconds(1000));
+  EXPECT_EQ(report.units, 4);
+  EXPECT_EQ(report.totalBytes, 116);
+  EXPECT_DOUBLE_EQ(report.durationMs, 61.0);
+  EXPECT_DOUBLE_EQ(report.intervalMs.front(), 10.0);
+  EXPECT_DOUBLE_EQ(report.intervalMs.back(), 40.0);
+  EXPECT_EQ(report.gapCount, 1);
+  EXPECT_EQ(report.longestGapUnit, 3);
+  EXPECT_EQ(report.windowCount, 1);
+}
+
+TEST_F(CaptureAnalyzerTest, RejectsLineWithoutUnitMarker) {
+  std::string log =
+      "2025-08-04 22:21:30.000000 - Video Unit: 6 bytes (length: 2)\n"
+      "2025-08-04 22:21:30.010000 - something else\n";
+
+  auto records = analyzer_.parseTimestampLog(log.data(), log.size());
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].bytes, 6);
+}
+
+TEST_F(CaptureAnalyzerTest, SkipsTimestampsThatGoBackwards) {
+  std::string log =
+      "2025-08-04 22:21:30.100000 - Video Unit: 10 bytes (length: 6)\n"
+      "2025-08-04 22:21:30.110000 - Video Unit: 10 bytes (length: 6)\n"
+      "2025-08-04 22:21:29.000000 - Video Unit: 10 bytes (length: 6)\n"
+      "2025-08-04 22:21:30.120000 - Video Unit: 10 bytes (length: 6)\n";
+
+  auto records = analyzer_.parseTimestampLog(log.data(), log.size());
+  ASSERT_EQ(records.size(), 4);
+
+  auto report = analyzer_.analyzeTiming(records, std::chrono::milliseconds(10),
+                                        std::chrono::milliseconds(5));
+  EXPECT_EQ(report.units, 4);
+  EXPECT_EQ(report.totalBytes, 40);
+  EXPECT_EQ(report.outOfOrder, 1);
+  EXPECT_DOUBLE_EQ(report.durationMs, 20.0);
+  EXPECT_DOUBLE_EQ(report.intervalMs.front(), 10.0);
+  EXPECT_DOUBLE_EQ(report.intervalMs.back(), 10.0);
+  EXPECT_EQ(report.gapCount, 0);
+  EXPECT_EQ(report.windowCount, 5);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "CaptureJournal.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+class CaptureJournalTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    dataFileName_ = "capture_journal_test.bin";
+    timestampFileName_ = "capture_journal_test.bin_timestamps.txt";
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(dataFileName_);
+    std::filesystem::remove(timestampFileName_);
+    std::filesystem::remove(CaptureJournal::journalPath(dataFileName_));
+  }
+
+  static void writeBytes(const std::string &fileName, size_t size) {
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file << std::string(size, 'x');
+  }
+
+  std::string dataFileName_;
+  std::string timestampFileName_;
+};
+
+TEST_F(CaptureJournalTest, ReadsNewestCommit) {
+  {
+    CaptureJournal journal(dataFileName_);
+    journal.commit(1, 100, 10);
+    journal.commit(2, 200, 20);
+    journal.commit(3, 300, 30);
+    EXPECT_EQ(journal.getCommitCount(), 3u);
+  }
+  EXPECT_EQ(std::filesystem::file_size(
+                CaptureJournal::journalPath(dataFileName_)),
+            CaptureJournal::RecordSizeBytes * CaptureJournal::SlotCount);
+
+  auto commit = CaptureJournal::readLastCommit(dataFileName_);
+  ASSERT_TRUE(commit.has_value());
+  EXPECT_EQ(commit->sequence, 3u);
+  EXPECT_EQ(commit->frames, 3u);
+  EXPECT_EQ(commit->dataBytes, 300u);
+  EXPECT_EQ(commit->timestampBytes, 30u);
+}
+
+TEST_F(CaptureJournalTest, TornRecordFallsBackToPreviousCommit) {
+  {
+    CaptureJournal journal(dataFileName_);
+    journal.commit(1, 100, 10);
+    journal.commit(2, 200, 20);
+  }
+  // Commit 2 sits in slot 0; damage it as a torn write would.
+  {
+    std::fstream journal(CaptureJournal::journalPath(dataFileName_),
+                         std::ios::binary | std::ios::in | std::ios::out);
+    journal.seekp(20);
+    journal.put('\x7f');
+  }
+
+  auto commit = CaptureJournal::readLastCommit(dataFileName_);
+  ASSERT_TRUE(commit.has_value());
+  EXPECT_EQ(commit->sequence, 1u);
+  EXPECT_EQ(commit->dataBytes, 100u);
+}
+
+TEST_F(CaptureJournalTest, RecoverTruncatesToLastCommit) {
+  {
+    CaptureJournal journal(dataFileName_);
+    journal.commit(4, 1000, 120);
+  }
+  writeBytes(dataFileName_, 1234);
+  writeBytes(timestampFileName_, 150);
+
+  auto dryRun =
+      CaptureJournal::recover(dataFileName_, timestampFileName_, true);
+  EXPECT_TRUE(dryRun.truncated);
+  EXPECT_EQ(dryRun.dataBytesFound, 1234u);
+  EXPECT_EQ(std::filesystem::file_size(dataFileName_), 1234u);
+
+  auto recovery = CaptureJournal::recover(dataFileName_, timestampFileName_);
+  ASSERT_TRUE(recovery.commit.has_value());
+  EXPECT_TRUE(recovery.truncated);
+  EXPECT_EQ(recovery.timestampBytesFound, 150u);
+  EXPECT_EQ(std::filesystem::file_size(dataFileName_), 1000u);
+  EXPECT_EQ(std::filesystem::file_size(timestampFileName_), 120u);
+
+  auto again = CaptureJournal::recover(dataFileName_, timestampFileName_);
+  EXPECT_FALSE(again.truncated);
+}
+
+TEST_F(CaptureJournalTest, RecoverWithoutCommitEmptiesCapture) {
+  { CaptureJournal journal(dataFileName_); }
+  writeBytes(dataFileName_, 50);
+  writeBytes(timestampFileName_, 5);
+
+  auto recovery = CaptureJournal::recover(dataFileName_, timestampFileName_);
+  EXPECT_FALSE(recovery.commit.has_value());
+  EXPECT_EQ(std::filesystem::file_size(dataFileName_), 0u);
+  EXPECT_EQ(std::filesystem::file_size(timestampFileName_), 0u);
+}
+
+TEST_F(CaptureJournalTest, RecoverRejectsShortCapture) {
+  {
+    CaptureJournal journal(dataFileName_);
+    journal.commit(1, 100, 0);
+  }
+  writeBytes(dataFileName_, 60);
+
+  EXPECT_THROW(CaptureJournal::recover(dataFileName_, timestampFileName_),
+               std::runtime_error);
+  EXPECT_THROW(CaptureJournal::readLastCommit("no_such_capture.bin"),
+               std::runtime_error);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "Codec.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+class CodecTest : public ::testing::TestWithParam<std::string> {
+protected:
+  void SetUp() override { codec_ = ICodec::fromName(GetParam()); }
+
+  std::vector<char> roundTrip(const std::vector<char> &input) {
+    std::vector<char> compressed(input.size() + 64);
+    size_t compressedSize = codec_->compress(input.data(), input.size(),
+                                             compressed.data(),
+                                             compressed.size());
+    EXPECT_GT(compressedSize, 0u);
+    compressed.resize(compressedSize);
+
+    std::vector<char> output(input.size());
+    EXPECT_TRUE(codec_->decompress(compressed.data(), compressed.size(),
+                                   output.data(), output.size()));
+    lastCompressedSize_ = compressedSize;
+    return output;
+  }
+
+  static std::vector<char> randomBytes(size_t size) {
+    std::mt19937 random(42);
+    std::vector<char> bytes(size);
+    for (auto &byte : bytes) {
+      byte = static_cast<char>(random() & 0xFF);
+    }
+    return bytes;
+  }
+
+  std::unique_ptr<ICodec> codec_;
+  size_t lastCompressedSize_ = 0;
+};
+
+TEST_P(CodecTest, RoundTripsRepetitiveDataSmaller) {
+  std::string text;
+  for (int i = 0; i < 200; ++i) {
+    text += "frame " + std::to_string(i % 7) + " of sensor data; ";
+  }
+  std::vector<char> input(text.begin(), text.end());
+
+  EXPECT_EQ(roundTrip(input), input);
+  EXPECT_LT(lastCompressedSize_, input.size() / 4);
+}
+
+TEST_P(CodecTest, RoundTripsLongRunsAndShortInputs) {
+  std::vector<char> run(5000, 'x');
+  EXPECT_EQ(roundTrip(run), run);
+
+  for (size_t size : {1u, 5u, 12u, 13u, 17u}) {
+    std::vector<char> small(size, 'a');
+    EXPECT_EQ(roundTrip(small), small) << "size " << size;
+  }
+}
+
+TEST_P(CodecTest, RoundTripsIncompressibleData) {
+  auto input = randomBytes(4096);
+  EXPECT_EQ(roundTrip(input), input);
+}
+
+TEST_P(CodecTest, ReportsOutputThatDoesNotFit) {
+  auto input = randomBytes(4096);
+  std::vector<char> compressed(input.size() / 2);
+
+  EXPECT_EQ(codec_->compress(input.data(), input.size(), compressed.data(),
+                             compressed.size()),
+            0u);
+}
+
+TEST_P(CodecTest, RejectsCorruptOrMismatchedInput) {
+  std::vector<char> input(1000, 'z');
+  std::vector<char> compressed(1100);
+  size_t compressedSize = codec_->compress(input.data(), input.size(),
+                                           compressed.data(), compressed.size());
+  std::vector<char> output(input.size());
+
+  EXPECT_FALSE(codec_->decompress(compressed.data(), compressedSize - 1,
+                                  output.data(), output.size()));
+  EXPECT_FALSE(codec_->decompress(compressed.data(), compressedSize,
+                                  output.data(), output.size() - 1));
+}
+
+INSTANTIATE_TEST_SUITE_P(Codecs, CodecTest,
+                         ::testing::Values("lz4", "deflate"));
+
+TEST(CodecFactoryTest, ResolvesNamesAndIds) {
+  EXPECT_EQ(ICodec::fromName("none"), nullptr);
+  EXPECT_EQ(ICodec::fromName("lz4")->getId(), Lz4Codec::Id);
+  EXPECT_STREQ(ICodec::fromId(DeflateCodec::Id)->getName(), "deflate");
+  EXPECT_THROW(ICodec::fromName("brotli"), std::runtime_error);
+  EXPECT_THROW(ICodec::fromId(0x0F), std::runtime_error);
+}
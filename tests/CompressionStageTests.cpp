@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "CompressionStage.hpp"
+#include "Codec.hpp"
+#include "Constants.hpp"
+#include "DataAcceptor.hpp"
+#include "DataFile.hpp"
+#include "DataUnitConverter.hpp"
+#include "StageTestDoubles.hpp"
+#include "TimestampWriter.hpp"
+#include "WorkerPool.hpp"
+
+#include <deque>
+#include <random>
+
+class CompressionStageTest : public ::testing::Test {
+protected:
+  static std::vector<char> frame(const std::vector<char> &payload,
+                                 uint8_t flags = 0) {
+    DataUnitConverter converter;
+    return converter.encodeDataUnit(
+        {static_cast<uint32_t>(payload.size()), payload, flags});
+  }
+
+  static std::vector<char> compressible(size_t size) {
+    std::vector<char> payload(size);
+    for (size_t i = 0; i < size; ++i) {
+      payload[i] = "sensor"[i % 6];
+    }
+    return payload;
+  }
+
+  static std::vector<char> incompressible(size_t size, unsigned seed) {
+    std::mt19937 random(seed);
+    std::vector<char> payload(size);
+    for (auto &byte : payload) {
+      byte = static_cast<char>(random() & 0xFF);
+    }
+    return payload;
+  }
+
+  std::shared_ptr<WorkerPool> pool_ = std::make_shared<WorkerPool>(2);
+};
+
+TEST_F(CompressionStageTest, CompressedFrameCarriesCodecFlagAndKeyframe) {
+  auto original = frame(compressible(4000), Constants::FlagKeyframe);
+  auto compressed = CompressionStage::compressFrame(Lz4Codec(), original);
+
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_LT(compressed->size(), original.size() / 4);
+  DataUnitConverter converter;
+  EXPECT_EQ(converter.decodeFlags(compressed->data(), compressed->size()),
+            Constants::FlagKeyframe | Lz4Codec::Id);
+  EXPECT_EQ(converter.decodeHeader(compressed.value()),
+            compressed->size() - Constants::HeaderSizeBytes);
+}
+
+TEST_F(CompressionStageTest, LeavesPoorlyCompressingFramesRaw) {
+  auto original = frame(incompressible(4000, 1));
+
+  EXPECT_FALSE(CompressionStage::compressFrame(Lz4Codec(), original));
+  EXPECT_FALSE(CompressionStage::compressFrame(Lz4Codec(), frame({'a'})));
+}
+
+TEST_F(CompressionStageTest, AcceptorRestoresOriginalFramesInOrder) {
+  std::deque<std::vector<char>> frames;
+  for (unsigned i = 0; i < 30; ++i) {
+    frames.push_back(frame(i % 3 == 0 ? incompressible(3000, i)
+                                      : compressible(3000 + i)));
+  }
+  auto expected = std::vector<std::vector<char>>(frames.begin(), frames.end());
+
+  for (const char *codecName : {"lz4", "deflate"}) {
+    CompressionStage stage(std::make_unique<FrameListProvider>(frames),
+                           ICodec::fromName(codecName), pool_, 4);
+    std::vector<std::vector<char>> written;
+    DataAcceptor acceptor(std::make_unique<CollectingDataFile>(written),
+                          std::make_unique<NullTimestampWriter>());
+    while (auto data = stage.getNextData()) {
+      acceptor.processRawData(data.value());
+    }
+
+    EXPECT_EQ(written, expected) << codecName;
+    EXPECT_EQ(stage.getStats().frames, 30u);
+    EXPECT_EQ(stage.getStats().compressedFrames, 20u);
+    EXPECT_EQ(acceptor.getCompressedUnitsReceived(), 20u);
+    EXPECT_GT(stage.getStats().ratio(), 2.0);
+  }
+}
+
+TEST_F(CompressionStageTest, BacksOffAfterRunOfPoorFrames) {
+  std::deque<std::vector<char>> frames;
+  for (unsigned i = 0; i < 100; ++i) {
+    frames.push_back(frame(incompressible(2000, i)));
+  }
+
+  CompressionStage stage(std::make_unique<FrameListProvider>(frames),
+                         std::make_unique<Lz4Codec>(), pool_, 1);
+  while (stage.getNextData()) {
+  }
+
+  const auto &stats = stage.getStats();
+  EXPECT_EQ(stats.frames, 100u);
+  EXPECT_EQ(stats.compressedFrames, 0u);
+  EXPECT_LT(stats.attemptedFrames, 100u - CompressionStage::BackoffFrames + 8);
+  EXPECT_EQ(stats.inputBytes, stats.outputBytes);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "ConfigFile.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+class ConfigFileTest : public ::testing::Test {
+protected:
+  void SetUp() override { configFileName_ = "test_config.conf"; }
+
+  void TearDown() override {
+    if (std::filesystem::exists(configFileName_)) {
+      std::filesystem::remove(configFileName_);
+    }
+  }
+
+  void writeConfig(const std::string &contents) {
+    std::ofstream file(configFileName_);
+    ASSERT_TRUE(file.is_open());
+    file << contents;
+  }
+
+  std::string configFileName_;
+};
+
+TEST_F(ConfigFileTest, LoadTurnsLinesIntoFlags) {
+  writeConfig("# sender settings\n"
+              "profile = latency\n"
+              "\n"
+              "  interval-ms=16.7   # 60 fps\n"
+              "multiplexed\n"
+              "codec = lz4,none\r\n");
+
+  auto arguments = ConfigFile::load(configFileName_);
+
+  std::vector<std::string> expected = {"--profile=latency",
+                                       "--interval-ms=16.7", "--multiplexed",
+                                       "--codec=lz4,none"};
+  EXPECT_EQ(arguments, expected);
+}
+
+TEST_F(ConfigFileTest, MalformedLineThrows) {
+  writeConfig("profile latency\n");
+  EXPECT_THROW(ConfigFile::load(configFileName_), std::runtime_error);
+
+  writeConfig("= latency\n");
+  EXPECT_THROW(ConfigFile::load(configFileName_), std::runtime_error);
+}
+
+TEST_F(ConfigFileTest, MissingFileThrows) {
+  EXPECT_THROW(ConfigFile::load("no_such_config.conf"), std::runtime_error);
+}
+
+TEST_F(ConfigFileTest, CommandLineOverridesFile) {
+  writeConfig("profile = latency\ncpu = 2\n");
+  std::string configArgument = "--config=" + configFileName_;
+  std::vector<std::string> argumentStrings = {
+      "sender", "input.bin", configArgument, "--profile=throughput"};
+  std::vector<char *> argv;
+  for (auto &argument : argumentStrings) {
+    argv.push_back(argument.data());
+  }
+
+  auto arguments =
+      ConfigFile::expandArguments(static_cast<int>(argv.size()), argv.data());
+
+  // The parsers keep the last value of a flag.
+  std::vector<std::string> expected = {"--profile=latency", "--cpu=2",
+                                       "input.bin", "--profile=throughput"};
+  EXPECT_EQ(arguments, expected);
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "ControlServer.hpp"
+
+#include <boost/asio.hpp>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include <unistd.h>
+
+using boost::asio::local::stream_protocol;
+
+class ControlServerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    socketPath_ = (std::filesystem::temp_directory_path() /
+                   ("vt_control_test_" + std::to_string(::getpid())))
+                      .string();
+    server_ = std::make_unique<ControlServer>(socketPath_);
+    server_->addCommand("add", "add <a> <b>",
+                        [](const std::vector<std::string> &args) {
+                          if (args.size() != 2) {
+                            throw std::runtime_error("usage: add <a> <b>");
+                          }
+                          return std::to_string(std::stoi(args[0]) +
+                                                std::stoi(args[1]));
+                        });
+  }
+
+  void TearDown() override {
+    server_.reset();
+    std::filesystem::remove(socketPath_);
+  }
+
+  // Sends one request and reads the reply up to its terminating empty line.
+  std::string request(stream_protocol::socket &socket,
+                      const std::string &line) {
+    boost::asio::write(socket, boost::asio::buffer(line + "\n"));
+    boost::asio::read_until(socket, response_, "\n\n");
+    std::string reply(boost::asio::buffers_begin(response_.data()),
+                      boost::asio::buffers_end(response_.data()));
+    auto end = reply.find("\n\n");
+    response_.consume(end + 2);
+    return reply.substr(0, end);
+  }
+
+  std::string socketPath_;
+  std::unique_ptr<ControlServer> server_;
+  boost::asio::streambuf response_;
+};
+
+TEST_F(ControlServerTest, ExecuteDispatchesByName) {
+  EXPECT_EQ(server_->execute("add 2 3"), "5");
+  EXPECT_EQ(server_->execute("  add   4  5 "), "9");
+}
+
+TEST_F(ControlServerTest, ErrorsAreReported) {
+  EXPECT_EQ(server_->execute("add 1"), "error: usage: add <a> <b>");
+  EXPECT_EQ(server_->execute("frobnicate").rfind("error: unknown command", 0),
+            0u);
+  EXPECT_EQ(server_->execute(""), "error: empty command");
+}
+
+TEST_F(ControlServerTest, HelpListsCommands) {
+  auto help = server_->execute("help");
+  EXPECT_NE(help.find("add <a> <b>"), std::string::npos);
+  EXPECT_NE(help.find("help"), std::string::npos);
+}
+
+TEST_F(ControlServerTest, ServesRequestsOverSocket) {
+  server_->start();
+  EXPECT_TRUE(std::filesystem::exists(socketPath_));
+
+  boost::asio::io_context ioContext;
+  stream_protocol::socket socket(ioContext);
+  socket.connect(stream_protocol::endpoint(socketPath_));
+
+  EXPECT_EQ(request(socket, "add 20 22"), "42");
+  EXPECT_EQ(request(socket, "add x"), "error: usage: add <a> <b>");
+  EXPECT_EQ(request(socket, "add 1 1"), "2");
+
+  socket.close();
+  server_->stop();
+  EXPECT_FALSE(std::filesystem::exists(socketPath_));
+}
+
+TEST_F(ControlServerTest, StartReplacesStaleSocket) {
+  {
+    // A closed listener leaves its socket file behind, like a crashed run.
+    boost::asio::io_context ioContext;
+    stream_protocol::acceptor stale(ioContext,
+                                    stream_protocol::endpoint(socketPath_));
+  }
+  ASSERT_TRUE(std::filesystem::is_socket(socketPath_));
+
+  server_->start();
+  boost::asio::io_context ioContext;
+  stream_protocol::socket socket(ioContext);
+  socket.connect(stream_protocol::endpoint(socketPath_));
+  EXPECT_EQ(request(socket, "add 1 2"), "3");
+}
+
+TEST_F(ControlServerTest, StartRefusesToTakeOverARunningServer) {
+  ControlServer running(socketPath_);
+  running.addCommand("ping", "ping",
+                     [](const std::vector<std::string> &) { return "pong"; });
+  running.start();
+
+  EXPECT_THROW(server_->start(), std::runtime_error);
+  boost::asio::io_context ioContext;
+  stream_protocol::socket socket(ioContext);
+  socket.connect(stream_protocol::endpoint(socketPath_));
+  EXPECT_EQ(request(socket, "ping"), "pong");
+}
+
+TEST_F(ControlServerTest, StartRefusesToReplaceAnythingButASocket) {
+  {
+    std::ofstream file(socketPath_);
+    file << "keep me";
+  }
+
+  EXPECT_THROW(server_->start(), std::runtime_error);
+  std::ifstream file(socketPath_);
+  std::string contents;
+  std::getline(file, contents);
+  EXPECT_EQ(contents, "keep me");
+}
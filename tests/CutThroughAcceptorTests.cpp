@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "CutThroughAcceptor.hpp"
+#include "DataUnitConverter.hpp"
+#include "FrameSink.hpp"
+
+#include <string>
+#include <vector>
+
+// Records the events a sink sees as one string per frame.
+class RecordingFrameSink : public IFrameSink {
+public:
+  void beginFrame(uint32_t length, uint8_t flags,
+                  std::chrono::system_clock::time_point) override {
+    events.push_back("begin " + std::to_string(length) + " " +
+                     std::to_string(flags) + ":");
+  }
+  void frameChunk(const char *data, size_t size) override {
+    events.back() += " [" + std::string(data, size) + "]";
+    chunks++;
+  }
+  void endFrame(std::chrono::system_clock::time_point) override {
+    events.back() += " end";
+  }
+
+  std::vector<std::string> events;
+  size_t chunks = 0;
+};
+
+class CutThroughAcceptorTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    auto sink = std::make_unique<RecordingFrameSink>();
+    sink_ = sink.get();
+    acceptor_ = std::make_unique<CutThroughAcceptor>(std::move(sink));
+  }
+
+  std::vector<char> encode(const std::string &payload, uint8_t flags = 0) {
+    DataUnit unit;
+    unit.length = static_cast<uint32_t>(payload.size());
+    unit.data.assign(payload.begin(), payload.end());
+    unit.flags = flags;
+    return converter_.encodeDataUnit(unit);
+  }
+
+  DataUnitConverter converter_;
+  RecordingFrameSink *sink_ = nullptr;
+  std::unique_ptr<CutThroughAcceptor> acceptor_;
+};
+
+TEST_F(CutThroughAcceptorTest, BeginsFrameBeforePayloadArrives) {
+  auto frame = encode("Hello", Constants::FlagKeyframe);
+
+  acceptor_->processRawData(
+      std::vector<char>(frame.begin(), frame.begin() + 6));
+  ASSERT_EQ(sink_->events.size(), 1u);
+  EXPECT_EQ(sink_->events[0], "begin 5 128: [He]");
+  EXPECT_EQ(acceptor_->getDataUnitsReceived(), 0u);
+
+  acceptor_->processRawData(std::vector<char>(frame.begin() + 6, frame.end()));
+  EXPECT_EQ(sink_->events[0], "begin 5 128: [He] [llo] end");
+  EXPECT_EQ(acceptor_->getDataUnitsReceived(), 1u);
+  EXPECT_EQ(acceptor_->getTotalBytesReceived(), frame.size());
+}
+
+TEST_F(CutThroughAcceptorTest, HeaderSplitAcrossReads) {
+  auto frame = encode("abc");
+  for (char byte : frame) {
+    acceptor_->processRawData(std::vector<char>{byte});
+  }
+
+  ASSERT_EQ(sink_->events.size(), 1u);
+  EXPECT_EQ(sink_->events[0], "begin 3 0: [a] [b] [c] end");
+  EXPECT_EQ(acceptor_->getStats().chunks, 3u);
+  EXPECT_DOUBLE_EQ(acceptor_->getStats().chunksPerFrame(), 3.0);
+}
+
+TEST_F(CutThroughAcceptorTest, SeveralFramesInOneRead) {
+  std::vector<char> rawData;
+  for (const std::string payload : {"one", "", "three"}) {
+    auto frame = encode(payload);
+    rawData.insert(rawData.end(), frame.begin(), frame.end());
+  }
+  auto tail = encode("four");
+  rawData.insert(rawData.end(), tail.begin(), tail.begin() + 5);
+
+  acceptor_->processRawData(rawData);
+
+  std::vector<std::string> expected = {"begin 3 0: [one] end", "begin 0 0: end",
+                                       "begin 5 0: [three] end",
+                                       "begin 4 0: [f]"};
+  EXPECT_EQ(sink_->events, expected);
+  EXPECT_EQ(acceptor_->getDataUnitsReceived(), 3u);
+}
+
+TEST_F(CutThroughAcceptorTest, LeadTimeSpansFirstToLastRead) {
+  auto frame = encode("payload");
+  auto begin = std::chrono::system_clock::time_point(std::chrono::seconds(1));
+
+  acceptor_->processRawData(std::vector<char>(frame.begin(), frame.begin() + 5),
+                            begin);
+  acceptor_->processRawData(std::vector<char>(frame.begin() + 5, frame.end()),
+                            begin + std::chrono::microseconds(250));
+
+  EXPECT_EQ(acceptor_->getStats().frames, 1u);
+  EXPECT_EQ(acceptor_->getStats().averageLeadTime(),
+            std::chrono::microseconds(250));
+}
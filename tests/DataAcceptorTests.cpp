@@ -17,6 +17,10 @@ public:
 class MockTextFileWriter : public ITimestampWriter {
 public:
   MOCK_METHOD(void, write, (const DataUnit &dataUnit), (override));
+  MOCK_METHOD(void, write,
+              (const DataUnit &dataUnit,
+               std::chrono::system_clock::time_point timestamp),
+              (override));
   MOCK_METHOD(void, open, (const std::string &filename), (override));
   MOCK_METHOD(void, close, (), (override));
 };
@@ -60,3 +64,62 @@ TEST_F(DataAcceptorTest, ProcessCompleteDataUnit) {
   EXPECT_EQ(dataAcceptor_->getDataUnitsReceived(), 1);
   EXPECT_EQ(dataAcceptor_->getTotalBytesReceived(), 6);
 }
+
+TEST_F(DataAcceptorTest, ProcessWithArrivalTime) {
+  std::vector<char> rawData = {0x00, 0x00, 0x00, 0x02, 'H', 'i'};
+  auto arrivalTime =
+      std::chrono::system_clock::time_point(std::chrono::seconds(1000));
+
+  EXPECT_CALL(*mockDataFile_, writeBinaryData(testing::_)).Times(1);
+  EXPECT_CALL(*mockTimestampWriter_, write(testing::_, arrivalTime))
+      .WillOnce(testing::Invoke(
+          [](const DataUnit &dataUnit,
+             std::chrono::system_clock::time_point) {
+            EXPECT_EQ(dataUnit.length, 2);
+          }));
+
+  dataAcceptor_ = std::make_unique<DataAcceptor>(
+      std::move(mockDataFile_), std::move(mockTimestampWriter_));
+
+  dataAcceptor_->processRawData(rawData, arrivalTime);
+
+  EXPECT_EQ(dataAcceptor_->getDataUnitsReceived(), 1);
+}
+
+TEST_F(DataAcceptorTest, ProcessTwoUnitsInOneRead) {
+  std::vector<char> rawData = {0x00, 0x00, 0x00, 0x02, 'H', 'i',
+                               0x00, 0x00, 0x00, 0x01, '!'};
+
+  EXPECT_CALL(*mockDataFile_, writeBinaryData(testing::_)).Times(2);
+  EXPECT_CALL(*mockTimestampWriter_, write(testing::_)).Times(2);
+
+  dataAcceptor_ = std::make_unique<DataAcceptor>(
+      std::move(mockDataFile_), std::move(mockTimestampWriter_));
+
+  dataAcceptor_->processRawData(rawData);
+
+  EXPECT_EQ(dataAcceptor_->getDataUnitsReceived(), 2);
+  EXPECT_EQ(dataAcceptor_->getTotalBytesReceived(), 11);
+}
+
+TEST_F(DataAcceptorTest, RotateSwitchesWritersAtNextUnit) {
+  std::vector<char> rawData = {0x00, 0x00, 0x00, 0x02, 'H', 'i'};
+  auto nextDataFile = std::make_unique<MockDataFile>();
+  auto nextTimestampWriter = std::make_unique<MockTextFileWriter>();
+
+  EXPECT_CALL(*mockDataFile_, writeBinaryData(testing::_)).Times(1);
+  EXPECT_CALL(*mockTimestampWriter_, write(testing::_)).Times(1);
+  EXPECT_CALL(*nextDataFile, writeBinaryData(testing::_)).Times(2);
+  EXPECT_CALL(*nextTimestampWriter, write(testing::_)).Times(2);
+
+  dataAcceptor_ = std::make_unique<DataAcceptor>(
+      std::move(mockDataFile_), std::move(mockTimestampWriter_));
+
+  dataAcceptor_->processRawData(rawData);
+  dataAcceptor_->rotate(std::move(nextDataFile),
+                        std::move(nextTimestampWriter));
+  dataAcceptor_->processRawData(rawData);
+  dataAcceptor_->processRawData(rawData);
+
+  EXPECT_EQ(dataAcceptor_->getDataUnitsReceived(), 3);
+}
@@ -69,6 +69,30 @@ TEST_F(DataFileTest, WriteAndReadDataUnit) {
   }
 }
 
+TEST_F(DataFileTest, EveryDurabilityWritesTheSameData) {
+  std::string writeFileName = "durability_test.bin";
+
+  DataUnit unit;
+  unit.length = 4;
+  unit.data = {'T', 'e', 's', 't'};
+  std::vector<char> binaryData = converter_->encodeDataUnit(unit);
+
+  for (const char *name : {"buffered", "flush", "sync"}) {
+    {
+      DataFile writeFile(writeFileName, DataFile::Mode::Write,
+                         DataFile::durabilityFromName(name));
+      writeFile.writeBinaryData(binaryData);
+      writeFile.writeBinaryData(binaryData);
+    }
+    EXPECT_EQ(std::filesystem::file_size(writeFileName),
+              2 * binaryData.size())
+        << name;
+  }
+  EXPECT_THROW(DataFile::durabilityFromName("never"), std::runtime_error);
+
+  std::filesystem::remove(writeFileName);
+}
+
 TEST_F(DataFileTest, ReadAllDataUnitsFromTestBin) {
   std::string testBinPath = "../../resources/front_0.bin";
 
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "DataUnitConverter.hpp"
 #include "DataUnit.hpp"
+#include "Constants.hpp"
 
 class DataUnitConverterTest : public ::testing::Test {
 protected:
@@ -49,3 +50,35 @@ TEST_F(DataUnitConverterTest, TwoBuffers) {
   EXPECT_EQ(secondUnit->data[3], 'D');
   EXPECT_EQ(secondUnit->data[4], 'E');
 }
+
+TEST_F(DataUnitConverterTest, FlagsRoundTripInHeaderTopByte) {
+  DataUnitConverter converter;
+  DataUnit keyframe{3, {'K', 'e', 'y'}, Constants::FlagKeyframe};
+
+  std::vector<char> binaryData = converter.encodeDataUnit(keyframe);
+  EXPECT_EQ(static_cast<uint8_t>(binaryData[0]), Constants::FlagKeyframe);
+  EXPECT_EQ(converter.decodeHeader(binaryData), 3);
+  EXPECT_EQ(converter.decodeFlags(binaryData.data(), binaryData.size()),
+            Constants::FlagKeyframe);
+
+  auto decoded = converter.decodeDataUnit(binaryData);
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->length, 3);
+  EXPECT_EQ(decoded->flags, Constants::FlagKeyframe);
+  EXPECT_EQ(converter.encodeDataUnit(decoded.value()), binaryData);
+}
+
+TEST_F(DataUnitConverterTest, RejectsReservedFlags) {
+  DataUnitConverter converter;
+  std::vector<char> binaryData = {0x10, 0x00, 0x00, 0x01, 'A'};
+
+  EXPECT_THROW(converter.decodeDataUnit(binaryData), std::runtime_error);
+}
+
+TEST_F(DataUnitConverterTest, RejectsOversizedLength) {
+  DataUnitConverter converter;
+  // Rejected from the header alone, before the payload arrives.
+  std::vector<char> binaryData = {0x00, 0x01, 0x00, 0x00};
+
+  EXPECT_THROW(converter.decodeDataUnit(binaryData), std::runtime_error);
+}
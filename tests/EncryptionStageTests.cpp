@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "EncryptionStage.hpp"
+#include "Codec.hpp"
+#include "CompressionStage.hpp"
+#include "Constants.hpp"
+#include "DataAcceptor.hpp"
+#include "DataFile.hpp"
+#include "DataUnitConverter.hpp"
+#include "FrameCipher.hpp"
+#include "StageTestDoubles.hpp"
+#include "TimestampWriter.hpp"
+#include "WorkerPool.hpp"
+
+#include <deque>
+
+class EncryptionStageTest : public ::testing::Test {
+protected:
+  void SetUp() override { key_.fill(0x42); }
+  void TearDown() override {}
+
+  static std::vector<char> frame(size_t size, uint8_t flags = 0) {
+    DataUnit unit;
+    unit.length = static_cast<uint32_t>(size);
+    unit.flags = flags;
+    for (size_t i = 0; i < size; ++i) {
+      unit.data.push_back(static_cast<char>("abcdabcd"[i % 8]));
+    }
+    return DataUnitConverter().encodeDataUnit(unit);
+  }
+
+  std::unique_ptr<DataAcceptor> makeAcceptor(bool withKey) {
+    auto acceptor = std::make_unique<DataAcceptor>(
+        std::make_unique<CollectingDataFile>(written_),
+        std::make_unique<NullTimestampWriter>());
+    if (withKey) {
+      acceptor->setCipher(std::make_unique<FrameCipher>(key_));
+    }
+    return acceptor;
+  }
+
+  FrameCipher::Key key_;
+  std::vector<std::vector<char>> written_;
+};
+
+TEST_F(EncryptionStageTest, CompressedAndEncryptedFramesRoundTrip) {
+  std::deque<std::vector<char>> input = {frame(4000, Constants::FlagKeyframe),
+                                         frame(1), frame(16383)};
+  auto compressed = std::make_unique<CompressionStage>(
+      std::make_unique<FrameListProvider>(input),
+      ICodec::fromName("lz4"), std::make_shared<WorkerPool>(1));
+  EncryptionStage stage(std::move(compressed),
+                        std::make_unique<FrameCipher>(key_));
+  auto acceptor = makeAcceptor(true);
+
+  while (auto sealed = stage.getNextData()) {
+    EXPECT_TRUE(static_cast<uint8_t>(sealed->front()) &
+                Constants::FlagEncrypted);
+    acceptor->processRawData(sealed.value());
+  }
+
+  EXPECT_EQ(written_, std::vector<std::vector<char>>(input.begin(),
+                                                     input.end()));
+  EXPECT_EQ(acceptor->getEncryptedUnitsReceived(), 3);
+  EXPECT_GT(acceptor->getCompressedUnitsReceived(), 0);
+  EXPECT_EQ(stage.getStats().frames, 3);
+  EXPECT_EQ(stage.getStats().overheadBytes, 3 * FrameCipher::OverheadBytes);
+}
+
+TEST_F(EncryptionStageTest, KeyedAcceptorRejectsPlaintextAndTampering) {
+  EXPECT_THROW(makeAcceptor(true)->processRawData(frame(10)),
+               std::runtime_error);
+
+  FrameCipher cipher(key_);
+  auto sealed = frame(10);
+  cipher.seal(sealed);
+  EXPECT_THROW(makeAcceptor(false)->processRawData(sealed),
+               std::runtime_error);
+
+  sealed.back() ^= 0x01;
+  EXPECT_THROW(makeAcceptor(true)->processRawData(sealed),
+               std::runtime_error);
+  EXPECT_TRUE(written_.empty());
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "FrameCipher.hpp"
+#include "Constants.hpp"
+#include "DataUnit.hpp"
+#include "DataUnitConverter.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+class FrameCipherTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    for (size_t i = 0; i < key_.size(); ++i) {
+      key_[i] = static_cast<unsigned char>(i * 7 + 1);
+    }
+  }
+
+  void TearDown() override { std::filesystem::remove(keyFileName_); }
+
+  static std::vector<char> frame(const std::string &payload,
+                                 uint8_t flags = 0) {
+    DataUnit unit;
+    unit.length = static_cast<uint32_t>(payload.size());
+    unit.data.assign(payload.begin(), payload.end());
+    unit.flags = flags;
+    return DataUnitConverter().encodeDataUnit(unit);
+  }
+
+  static DataUnit decode(const std::vector<char> &encoded) {
+    DataUnitConverter converter;
+    auto unit = converter.decodeDataUnit(encoded);
+    EXPECT_TRUE(unit.has_value());
+    return unit.value_or(DataUnit{});
+  }
+
+  FrameCipher::Key key_;
+  std::string keyFileName_ = "frame_cipher_test.key";
+};
+
+TEST_F(FrameCipherTest, SealAndOpenRoundTrip) {
+  FrameCipher sender(key_);
+  FrameCipher receiver(key_);
+  auto sealed = frame("video payload", Constants::FlagKeyframe | 0x01);
+
+  sender.seal(sealed);
+
+  EXPECT_EQ(sealed.size(), Constants::HeaderSizeBytes + 13 +
+                               FrameCipher::OverheadBytes);
+  EXPECT_EQ(std::string(sealed.begin(), sealed.end()).find("video payload"),
+            std::string::npos);
+  DataUnit unit = decode(sealed);
+  EXPECT_EQ(unit.flags, Constants::FlagKeyframe | Constants::FlagEncrypted |
+                            0x01);
+
+  ASSERT_TRUE(receiver.open(unit));
+  EXPECT_EQ(std::string(unit.data.begin(), unit.data.end()), "video payload");
+  EXPECT_EQ(unit.length, 13);
+  EXPECT_EQ(unit.flags, Constants::FlagKeyframe | 0x01);
+}
+
+TEST_F(FrameCipherTest, SealsWithoutMovingThePayload) {
+  FrameCipher cipher(key_);
+  auto sealed = frame("in place");
+  sealed.reserve(Constants::StreamIdSizeBytes + sealed.size() +
+                 FrameCipher::OverheadBytes);
+  const char *storage = sealed.data();
+
+  cipher.seal(sealed);
+
+  EXPECT_EQ(sealed.data(), storage);
+  DataUnit unit = decode(sealed);
+  ASSERT_TRUE(FrameCipher(key_).open(unit));
+  EXPECT_EQ(std::string(unit.data.begin(), unit.data.end()), "in place");
+}
+
+TEST_F(FrameCipherTest, NoncesNeverRepeat) {
+  FrameCipher cipher(key_);
+  auto first = frame("same");
+  auto second = frame("same");
+
+  cipher.seal(first);
+  cipher.seal(second);
+
+  EXPECT_NE(first, second);
+}
+
+TEST_F(FrameCipherTest, RejectsTamperedPayloadHeaderAndKey) {
+  FrameCipher sender(key_);
+  auto sealed = frame("authenticated");
+  sender.seal(sealed);
+
+  DataUnit payload = decode(sealed);
+  payload.data[0] ^= 0x01;
+  EXPECT_FALSE(FrameCipher(key_).open(payload));
+
+  // Flipping the keyframe flag changes the associated data.
+  DataUnit header = decode(sealed);
+  header.flags |= Constants::FlagKeyframe;
+  EXPECT_FALSE(FrameCipher(key_).open(header));
+
+  FrameCipher::Key otherKey = key_;
+  otherKey[0] ^= 0xFF;
+  DataUnit wrongKey = decode(sealed);
+  EXPECT_FALSE(FrameCipher(otherKey).open(wrongKey));
+
+  DataUnit intact = decode(sealed);
+  EXPECT_TRUE(FrameCipher(key_).open(intact));
+}
+
+TEST_F(FrameCipherTest, BindsFramesToTheirStream) {
+  FrameCipher sender(key_, 1);
+  auto sealed = frame("stream one");
+  sender.seal(sealed);
+
+  DataUnit otherStream = decode(sealed);
+  EXPECT_FALSE(FrameCipher(key_, 2).open(otherStream));
+  DataUnit sameStream = decode(sealed);
+  EXPECT_TRUE(FrameCipher(key_, 1).open(sameStream));
+}
+
+TEST_F(FrameCipherTest, RejectsReplayedAndReorderedFrames) {
+  FrameCipher sender(key_);
+  FrameCipher receiver(key_);
+  auto first = frame("first");
+  auto second = frame("second");
+  sender.seal(first);
+  sender.seal(second);
+
+  DataUnit secondUnit = decode(second);
+  ASSERT_TRUE(receiver.open(secondUnit));
+  DataUnit late = decode(first);
+  EXPECT_FALSE(receiver.open(late));
+  DataUnit replayed = decode(second);
+  EXPECT_FALSE(receiver.open(replayed));
+}
+
+TEST_F(FrameCipherTest, RejectsFramesFromAnotherSession) {
+  FrameCipher sender(key_);
+  FrameCipher receiver(key_);
+  FrameCipher earlierSession(key_);
+  auto first = frame("first");
+  auto injected = frame("injected");
+  auto second = frame("second");
+  sender.seal(first);
+  earlierSession.seal(injected);
+  sender.seal(second);
+
+  DataUnit firstUnit = decode(first);
+  ASSERT_TRUE(receiver.open(firstUnit));
+  DataUnit injectedUnit = decode(injected);
+  EXPECT_FALSE(receiver.open(injectedUnit));
+  DataUnit secondUnit = decode(second);
+  ASSERT_TRUE(receiver.open(secondUnit));
+  EXPECT_EQ(std::string(secondUnit.data.begin(), secondUnit.data.end()),
+            "second");
+}
+
+TEST_F(FrameCipherTest, LoadsRawAndHexKeys) {
+  {
+    std::ofstream file(keyFileName_, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(key_.data()), key_.size());
+  }
+  EXPECT_EQ(FrameCipher::loadKey(keyFileName_), key_);
+
+  {
+    std::ofstream file(keyFileName_);
+    for (unsigned char byte : key_) {
+      file << "0123456789abcdef"[byte >> 4] << "0123456789abcdef"[byte & 0x0F];
+    }
+    file << "\n";
+  }
+  EXPECT_EQ(FrameCipher::loadKey(keyFileName_), key_);
+
+  {
+    std::ofstream file(keyFileName_);
+    file << "too short";
+  }
+  EXPECT_THROW(FrameCipher::loadKey(keyFileName_), std::runtime_error);
+}
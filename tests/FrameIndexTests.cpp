@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "FrameIndex.hpp"
+#include "MappedFile.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+class FrameIndexTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    testFileName_ = "test_frame_index.bin";
+    writeFrames({"Hello", "Video", "!"});
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(testFileName_);
+    std::filesystem::remove(FrameIndex::indexPath(testFileName_));
+  }
+
+  void writeFrames(const std::vector<std::string> &frames) {
+    std::ofstream file(testFileName_, std::ios::binary | std::ios::trunc);
+    ASSERT_TRUE(file.is_open());
+    for (const auto &frame : frames) {
+      uint32_t length = static_cast<uint32_t>(frame.size());
+      for (int i = 3; i >= 0; --i) {
+        file.put(static_cast<char>((length >> (8 * i)) & 0xFF));
+      }
+      file.write(frame.data(), frame.size());
+    }
+  }
+
+  // Overwrites a native-order field of the saved index.
+  template <typename T> void patchIndex(std::streamoff offset, T value) {
+    std::fstream index(FrameIndex::indexPath(testFileName_),
+                       std::ios::binary | std::ios::in | std::ios::out);
+    ASSERT_TRUE(index.is_open());
+    index.seekp(offset);
+    index.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  std::string testFileName_;
+};
+
+TEST_F(FrameIndexTest, BuildsOffsetsOfEveryFrame) {
+  MappedFile file(testFileName_);
+  auto index = FrameIndex::build(testFileName_, file);
+
+  ASSERT_EQ(index.size(), 3);
+  EXPECT_EQ(index[0].offset, 0);
+  EXPECT_EQ(index[1].offset, 9);
+  EXPECT_EQ(index[2].offset, 18);
+  EXPECT_EQ(index[2].length, 1);
+  EXPECT_FALSE(index.wasLoaded());
+}
+
+TEST_F(FrameIndexTest, LoadOrBuildReusesSavedIndex) {
+  {
+    MappedFile file(testFileName_);
+    auto built = FrameIndex::loadOrBuild(testFileName_, file);
+    EXPECT_FALSE(built.wasLoaded());
+  }
+  ASSERT_TRUE(std::filesystem::exists(FrameIndex::indexPath(testFileName_)));
+
+  MappedFile file(testFileName_);
+  auto loaded = FrameIndex::loadOrBuild(testFileName_, file);
+  EXPECT_TRUE(loaded.wasLoaded());
+  ASSERT_EQ(loaded.size(), 3);
+  EXPECT_EQ(loaded[1].offset, 9);
+  EXPECT_EQ(loaded[1].length, 5);
+}
+
+TEST_F(FrameIndexTest, IgnoresIndexOfChangedRecording) {
+  {
+    MappedFile file(testFileName_);
+    FrameIndex::build(testFileName_, file).save(testFileName_);
+  }
+  writeFrames({"Hello", "Video", "!", "More"});
+
+  MappedFile file(testFileName_);
+  EXPECT_FALSE(FrameIndex::load(testFileName_, file).has_value());
+  EXPECT_EQ(FrameIndex::loadOrBuild(testFileName_, file).size(), 4);
+}
+
+TEST_F(FrameIndexTest, RejectsBrokenFraming) {
+  std::filesystem::resize_file(testFileName_, 20);
+  MappedFile file(testFileName_);
+
+  EXPECT_THROW(FrameIndex::build(testFileName_, file), std::runtime_error);
+}
+
+TEST_F(FrameIndexTest, RebuildsIndexWithImpossibleFrameCount) {
+  MappedFile file(testFileName_);
+  FrameIndex::build(testFileName_, file).save(testFileName_);
+  patchIndex<uint64_t>(24, uint64_t(1) << 60);
+
+  EXPECT_FALSE(FrameIndex::load(testFileName_, file).has_value());
+  auto index = FrameIndex::loadOrBuild(testFileName_, file);
+  EXPECT_FALSE(index.wasLoaded());
+  EXPECT_EQ(index.size(), 3);
+}
+
+TEST_F(FrameIndexTest, RebuildsIndexPointingPastTheRecording) {
+  MappedFile file(testFileName_);
+  FrameIndex::build(testFileName_, file).save(testFileName_);
+  // Length of the last frame, after the 32-byte header and two entries.
+  patchIndex<uint32_t>(32 + 2 * 12 + 8, 1000);
+
+  EXPECT_FALSE(FrameIndex::load(testFileName_, file).has_value());
+  auto index = FrameIndex::loadOrBuild(testFileName_, file);
+  EXPECT_FALSE(index.wasLoaded());
+  EXPECT_EQ(index[2].length, 1);
+}
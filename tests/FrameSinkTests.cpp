@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "CutThroughAcceptor.hpp"
+#include "DataAcceptor.hpp"
+#include "DataFile.hpp"
+#include "DataUnitConverter.hpp"
+#include "FrameSink.hpp"
+#include "TimestampWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+class FrameSinkTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    inputFileName_ = "../../resources/front_0.bin";
+    outputFileName_ = "frame_sink_test.bin";
+    input_ = readFile(inputFileName_);
+    ASSERT_FALSE(input_.empty());
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(outputFileName_);
+    std::filesystem::remove(outputFileName_ + "_timestamps.txt");
+  }
+
+  static std::vector<char> readFile(const std::string &fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+  }
+
+  // Feeds the recording in reads of random size, as a socket would.
+  void feedInRandomReads(IDataAcceptor &acceptor) {
+    std::mt19937 random(7);
+    std::uniform_int_distribution<size_t> readSize(1, 3000);
+    for (size_t offset = 0; offset < input_.size();) {
+      size_t size = std::min(readSize(random), input_.size() - offset);
+      acceptor.processRawData(std::vector<char>(
+          input_.begin() + offset, input_.begin() + offset + size));
+      offset += size;
+    }
+  }
+
+  std::string inputFileName_;
+  std::string outputFileName_;
+  std::vector<char> input_;
+};
+
+TEST_F(FrameSinkTest, FileSinkWritesRecordingUnchanged) {
+  {
+    CutThroughAcceptor acceptor(std::make_unique<FileFrameSink>(
+        std::make_unique<DataFile>(outputFileName_, DataFile::Mode::Write),
+        std::make_unique<TimestampWriter>(outputFileName_ +
+                                          "_timestamps.txt")));
+    feedInRandomReads(acceptor);
+    EXPECT_EQ(acceptor.getDataUnitsReceived(), 10u);
+    EXPECT_GT(acceptor.getStats().chunks, 10u);
+  }
+
+  EXPECT_EQ(readFile(outputFileName_), input_);
+}
+
+TEST_F(FrameSinkTest, FileSinkRejectsCompressedUnits) {
+  FileFrameSink sink(
+      std::make_unique<DataFile>(outputFileName_, DataFile::Mode::Write),
+      std::make_unique<TimestampWriter>(outputFileName_ + "_timestamps.txt"));
+
+  EXPECT_THROW(sink.beginFrame(8, 0x01, std::chrono::system_clock::now()),
+               std::runtime_error);
+  EXPECT_THROW(sink.beginFrame(8, Constants::FlagEncrypted,
+                               std::chrono::system_clock::now()),
+               std::runtime_error);
+}
+
+TEST_F(FrameSinkTest, AssemblerMatchesWholeFrameDecoding) {
+  std::vector<DataUnit> assembled;
+  CutThroughAcceptor acceptor(std::make_unique<FrameAssembler>(
+      [&assembled](DataUnit &&unit, std::chrono::system_clock::time_point) {
+        assembled.push_back(std::move(unit));
+      }));
+  feedInRandomReads(acceptor);
+
+  DataUnitConverter converter;
+  std::vector<DataUnit> decoded;
+  for (auto unit = converter.decodeDataUnit(input_); unit.has_value();
+       unit = converter.decodeDataUnit({})) {
+    decoded.push_back(unit.value());
+  }
+
+  ASSERT_EQ(assembled.size(), decoded.size());
+  for (size_t i = 0; i < decoded.size(); ++i) {
+    EXPECT_EQ(assembled[i].length, decoded[i].length);
+    EXPECT_EQ(assembled[i].flags, decoded[i].flags);
+    EXPECT_EQ(assembled[i].data, decoded[i].data);
+  }
+}
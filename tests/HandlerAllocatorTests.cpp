@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "HandlerAllocator.hpp"
+
+#include <boost/asio.hpp>
+
+class HandlerAllocatorTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(HandlerAllocatorTest, ReusesStorageOnceReleased) {
+  HandlerMemory memory;
+
+  void *first = memory.allocate(64);
+  memory.deallocate(first);
+  void *second = memory.allocate(64);
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(memory.getRecycledAllocations(), 2u);
+  memory.deallocate(second);
+}
+
+TEST_F(HandlerAllocatorTest, FallsBackToHeapWhileInUse) {
+  HandlerMemory memory;
+
+  void *inUse = memory.allocate(64);
+  void *overflow = memory.allocate(64);
+  void *oversized = HandlerMemory().allocate(1 << 20);
+
+  EXPECT_NE(inUse, overflow);
+  EXPECT_EQ(memory.getHeapAllocations(), 1u);
+  memory.deallocate(overflow);
+  memory.deallocate(inUse);
+  ::operator delete(oversized);
+}
+
+TEST_F(HandlerAllocatorTest, AsioUsesAssociatedAllocator) {
+  boost::asio::io_context ioContext;
+  HandlerMemory memory;
+  int invocations = 0;
+
+  std::function<void()> postNext = [&]() {
+    boost::asio::post(ioContext, makeRecyclingHandler(memory, [&]() {
+                        if (++invocations < 100) {
+                          postNext();
+                        }
+                      }));
+  };
+  postNext();
+  ioContext.run();
+
+  // Asio frees each operation before invoking its handler, so the next post
+  // finds the storage free again.
+  EXPECT_EQ(invocations, 100);
+  EXPECT_EQ(memory.getRecycledAllocations(), 100u);
+  EXPECT_EQ(memory.getHeapAllocations(), 0u);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "ImpairmentModel.hpp"
+
+#include <set>
+
+using namespace std::chrono_literals;
+
+class ImpairmentModelTest : public ::testing::Test {
+protected:
+  static std::set<size_t> cutPoints(ImpairmentModel &model,
+                                    const std::vector<size_t> &chunks) {
+    std::set<size_t> cuts;
+    size_t base = 0;
+    for (size_t chunk : chunks) {
+      for (const auto &segment : model.schedule(chunk, arrival_)) {
+        cuts.insert(base + segment.offset + segment.size);
+      }
+      base += chunk;
+    }
+    return cuts;
+  }
+
+  static inline const ImpairmentModel::Clock::time_point arrival_ =
+      ImpairmentModel::Clock::now();
+};
+
+TEST_F(ImpairmentModelTest, UnimpairedLinkForwardsReadsImmediately) {
+  ImpairmentModel model(ImpairmentConfig{});
+
+  auto segments = model.schedule(1000, arrival_);
+
+  ASSERT_EQ(segments.size(), 1);
+  EXPECT_EQ(segments[0].size, 1000);
+  EXPECT_EQ(segments[0].departure, arrival_);
+}
+
+TEST_F(ImpairmentModelTest, CutPointsDependOnSeedNotOnReadSizes) {
+  ImpairmentConfig config;
+  config.minSegmentBytes = 1;
+  config.maxSegmentBytes = 40;
+  config.seed = 7;
+
+  ImpairmentModel whole(config);
+  ImpairmentModel chunked(config);
+  auto wholeCuts = cutPoints(whole, {350});
+  auto chunkedCuts = cutPoints(chunked, {100, 50, 200});
+
+  // Read boundaries add cuts of their own but never move the drawn ones.
+  wholeCuts.insert({100, 150});
+  EXPECT_EQ(chunkedCuts, wholeCuts);
+
+  ImpairmentModel replay(config);
+  config.seed = 8;
+  ImpairmentModel reseeded(config);
+  EXPECT_NE(cutPoints(reseeded, {350}), cutPoints(replay, {350}));
+}
+
+TEST_F(ImpairmentModelTest, SegmentsStayWithinConfiguredSizes) {
+  ImpairmentConfig config;
+  config.minSegmentBytes = 3;
+  config.maxSegmentBytes = 9;
+  ImpairmentModel model(config);
+
+  auto segments = model.schedule(10000, arrival_);
+
+  for (size_t i = 0; i + 1 < segments.size(); ++i) {
+    EXPECT_GE(segments[i].size, 3);
+    EXPECT_LE(segments[i].size, 9);
+  }
+  EXPECT_EQ(model.getSegments(), segments.size());
+}
+
+TEST_F(ImpairmentModelTest, BandwidthSpacesSegmentsAfterDelay) {
+  ImpairmentConfig config;
+  config.delay = 5ms;
+  config.bandwidthBytesPerSecond = 1000;
+  config.minSegmentBytes = 100;
+  config.maxSegmentBytes = 100;
+  ImpairmentModel model(config);
+
+  auto segments = model.schedule(200, arrival_);
+
+  ASSERT_EQ(segments.size(), 2);
+  EXPECT_EQ(segments[0].departure - arrival_, 105ms);
+  EXPECT_EQ(segments[1].departure - arrival_, 205ms);
+}
+
+TEST_F(ImpairmentModelTest, JitterNeverReordersTheStream) {
+  ImpairmentConfig config;
+  config.delay = 10ms;
+  config.jitter = 8ms;
+  config.minSegmentBytes = 1;
+  config.maxSegmentBytes = 10;
+  ImpairmentModel model(config);
+
+  auto previous = arrival_;
+  for (int read = 0; read < 50; ++read) {
+    auto readArrival = arrival_ + std::chrono::microseconds(read * 100);
+    for (const auto &segment : model.schedule(37, readArrival)) {
+      EXPECT_GE(segment.departure, previous);
+      EXPECT_GE(segment.departure, readArrival + 2ms);
+      previous = segment.departure;
+    }
+  }
+}
+
+TEST_F(ImpairmentModelTest, StallsHoldTheLink) {
+  ImpairmentConfig config;
+  config.minSegmentBytes = 10;
+  config.maxSegmentBytes = 10;
+  config.stallProbability = 1.0;
+  config.stallDuration = 50ms;
+  ImpairmentModel model(config);
+
+  auto segments = model.schedule(30, arrival_);
+
+  ASSERT_EQ(segments.size(), 3);
+  EXPECT_EQ(model.getStalls(), 3);
+  EXPECT_EQ(segments[2].departure - arrival_, 150ms);
+}
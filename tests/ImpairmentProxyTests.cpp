@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "AsioReceiver.hpp"
+#include "AsioSender.hpp"
+#include "DataAcceptor.hpp"
+#include "DataFile.hpp"
+#include "DataProvider.hpp"
+#include "DataUnitConverter.hpp"
+#include "ImpairmentProxy.hpp"
+#include "TimestampWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+class ImpairmentProxyTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    inputFileName_ = "../../resources/front_0.bin";
+    outputFileName_ = "impairment_proxy_test.bin";
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(outputFileName_);
+    std::filesystem::remove(outputFileName_ + "_timestamps.txt");
+  }
+
+  // Sends the input file through a proxy with `config` and returns how long
+  // the transfer took.
+  std::chrono::steady_clock::duration transfer(ImpairmentConfig config) {
+    auto receiver = std::make_unique<AsioReceiver>(
+        0, std::make_unique<DataAcceptor>(
+               std::make_unique<DataFile>(outputFileName_,
+                                          DataFile::Mode::Write),
+               std::make_unique<TimestampWriter>(outputFileName_ +
+                                                 "_timestamps.txt")));
+    std::thread receiverThread([&receiver]() { receiver->start(); });
+    proxy_ = std::make_unique<ImpairmentProxy>(0, "127.0.0.1",
+                                               receiver->getPort(), config);
+    proxy_->start();
+
+    auto start = std::chrono::steady_clock::now();
+    {
+      AsioSender sender("127.0.0.1", proxy_->getPort(),
+                        std::make_unique<DataProvider>(
+                            std::make_unique<DataFile>(inputFileName_)));
+      sender.startTransport(1ms);
+    }
+    proxy_->wait();
+    receiverThread.join();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    unitsReceived_ = receiver->getDataUnitsReceived();
+    return elapsed;
+  }
+
+  static std::vector<char> readFile(const std::string &fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+  }
+
+  std::string inputFileName_;
+  std::string outputFileName_;
+  std::unique_ptr<ImpairmentProxy> proxy_;
+  size_t unitsReceived_ = 0;
+};
+
+TEST_F(ImpairmentProxyTest, ReassemblesTinyJitteredSegments) {
+  ImpairmentConfig config;
+  config.delay = 200us;
+  config.jitter = 150us;
+  config.minSegmentBytes = 1;
+  config.maxSegmentBytes = 7;
+  config.seed = 3;
+
+  transfer(config);
+
+  EXPECT_EQ(unitsReceived_, 10);
+  EXPECT_EQ(readFile(outputFileName_), readFile(inputFileName_));
+  EXPECT_EQ(proxy_->getBytesForwarded(), readFile(inputFileName_).size());
+  EXPECT_GT(proxy_->getSegmentsForwarded(), 21003u / 7);
+}
+
+TEST_F(ImpairmentProxyTest, BandwidthCapAndStallsSlowTheTransfer) {
+  ImpairmentConfig config;
+  config.bandwidthBytesPerSecond = 200000;
+  config.minSegmentBytes = 512;
+  config.maxSegmentBytes = 1460;
+  config.stallProbability = 0.3;
+  config.stallDuration = 5ms;
+  config.bufferBytes = 4096;
+
+  auto elapsed = transfer(config);
+
+  EXPECT_EQ(readFile(outputFileName_), readFile(inputFileName_));
+  // 21003 bytes at 200 kB/s need at least 105 ms on the wire.
+  EXPECT_GE(elapsed, 105ms);
+  EXPECT_GT(proxy_->getStalls(), 0u);
+}
+
+TEST_F(ImpairmentProxyTest, ClosesClientWhenTargetGoesAway) {
+  boost::asio::io_context ioContext;
+  boost::asio::ip::tcp::acceptor target(
+      ioContext, boost::asio::ip::tcp::endpoint(
+                     boost::asio::ip::address_v4::loopback(), 0));
+  proxy_ = std::make_unique<ImpairmentProxy>(
+      0, "127.0.0.1", target.local_endpoint().port(), ImpairmentConfig());
+  proxy_->start();
+
+  boost::asio::ip::tcp::socket client(ioContext);
+  client.connect(boost::asio::ip::tcp::endpoint(
+      boost::asio::ip::address_v4::loopback(), proxy_->getPort()));
+  {
+    // Reset the proxied connection, like a receiver that crashed.
+    boost::asio::ip::tcp::socket accepted(ioContext);
+    target.accept(accepted);
+    accepted.set_option(boost::asio::socket_base::linger(true, 0));
+  }
+
+  std::vector<char> chunk(256, 'x');
+  boost::system::error_code error;
+  for (int i = 0; i < 200 && !error; ++i) {
+    boost::asio::write(client, boost::asio::buffer(chunk), error);
+    std::this_thread::sleep_for(5ms);
+  }
+  EXPECT_TRUE(error);
+  proxy_->wait();
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "IndexedDataFile.hpp"
+#include "DataFile.hpp"
+#include "DataProvider.hpp"
+#include "DataUnitConverter.hpp"
+
+#include <filesystem>
+
+class IndexedDataFileTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    std::filesystem::copy_file(
+        "../../resources/front_0.bin", testFileName_,
+        std::filesystem::copy_options::overwrite_existing);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(testFileName_);
+    std::filesystem::remove(FrameIndex::indexPath(testFileName_));
+  }
+
+  std::string testFileName_ = "test_indexed_data_file.bin";
+};
+
+TEST_F(IndexedDataFileTest, ReadsSameUnitsAsDataFile) {
+  IndexedDataFile indexed(testFileName_);
+  DataFile streamed(testFileName_);
+
+  EXPECT_EQ(indexed.getFrameCount(), 10);
+  while (auto expected = streamed.readNextDataUnit()) {
+    auto actual = indexed.readNextDataUnit();
+    ASSERT_TRUE(actual.has_value());
+    EXPECT_EQ(actual.value(), expected.value());
+  }
+  EXPECT_FALSE(indexed.readNextDataUnit().has_value());
+}
+
+TEST_F(IndexedDataFileTest, PrefaultCoversRequestedFrames) {
+  IndexedDataFile indexed(testFileName_);
+
+  EXPECT_EQ(indexed.prefault(0), 0);
+  EXPECT_EQ(indexed.prefault(100),
+            std::filesystem::file_size(testFileName_));
+  EXPECT_EQ(indexed.prefault(1), 6); // 4-byte header + 2-byte first frame
+}
+
+TEST_F(IndexedDataFileTest, PrefetchedUnitsComeFirst) {
+  DataProvider provider(std::make_unique<IndexedDataFile>(testFileName_));
+  DataFile streamed(testFileName_);
+
+  EXPECT_EQ(provider.prefetch(3), 3);
+  size_t units = 0;
+  while (auto expected = streamed.readNextDataUnit()) {
+    EXPECT_EQ(provider.getNextData(), expected);
+    ++units;
+  }
+  EXPECT_EQ(units, 10);
+  EXPECT_FALSE(provider.getNextData().has_value());
+}
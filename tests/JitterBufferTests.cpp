@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "JitterBuffer.hpp"
+#include "Constants.hpp"
+#include "DataUnit.hpp"
+#include "DataUnitConverter.hpp"
+
+#include <mutex>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+class PlayoutRecorder : public IDataAcceptor {
+public:
+  struct Release {
+    std::vector<char> frame;
+    JitterBuffer::Clock::time_point time;
+  };
+
+  explicit PlayoutRecorder(std::vector<Release> &releases)
+      : releases_(releases) {}
+
+  void processRawData(const std::vector<char> &rawData) override {
+    releases_.push_back({rawData, JitterBuffer::Clock::now()});
+  }
+  void processRawData(const std::vector<char> &rawData,
+                      std::chrono::system_clock::time_point) override {
+    processRawData(rawData);
+  }
+  size_t getDataUnitsReceived() const override { return releases_.size(); }
+  size_t getTotalBytesReceived() const override { return 0; }
+
+private:
+  std::vector<Release> &releases_;
+};
+
+class JitterBufferTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static std::vector<char> frame(char tag) {
+    DataUnit unit;
+    unit.length = 3;
+    unit.data = {tag, tag, tag};
+    return DataUnitConverter().encodeDataUnit(unit);
+  }
+
+  std::unique_ptr<JitterBuffer> makeBuffer(JitterBufferConfig config) {
+    return std::make_unique<JitterBuffer>(
+        std::make_unique<PlayoutRecorder>(releases_), config);
+  }
+
+  std::vector<PlayoutRecorder::Release> releases_;
+};
+
+TEST_F(JitterBufferTest, SmoothsABurstOntoThePlayoutClock) {
+  JitterBufferConfig config;
+  config.interval = 5ms;
+  config.initialDelay = 10ms;
+  auto buffer = makeBuffer(config);
+
+  std::vector<char> burst;
+  for (char tag = 'a'; tag < 'a' + 8; ++tag) {
+    auto encoded = frame(tag);
+    burst.insert(burst.end(), encoded.begin(), encoded.end());
+  }
+  auto arrival = JitterBuffer::Clock::now();
+  // Split mid-unit to check that units are reassembled before buffering.
+  buffer->processRawData(std::vector<char>(burst.begin(), burst.begin() + 10));
+  buffer->processRawData(std::vector<char>(burst.begin() + 10, burst.end()));
+  buffer->drain();
+
+  ASSERT_EQ(releases_.size(), 8);
+  for (size_t i = 0; i < releases_.size(); ++i) {
+    EXPECT_EQ(releases_[i].frame, frame(static_cast<char>('a' + i)));
+    // Releases sit on the playout grid behind the target delay, which
+    // decays slightly below its initial value during the burst.
+    auto offset = releases_[i].time - arrival;
+    EXPECT_GE(offset, static_cast<int>(i) * 5ms + 8ms);
+    EXPECT_LE(offset, static_cast<int>(i) * 5ms + 20ms);
+  }
+  EXPECT_EQ(buffer->getDataUnitsReceived(), 8);
+  EXPECT_EQ(buffer->getStats().maxOccupancy, 8);
+}
+
+TEST_F(JitterBufferTest, LateFrameCountsUnderrunAndRaisesTargetDelay) {
+  JitterBufferConfig config;
+  config.interval = 5ms;
+  config.initialDelay = 5ms;
+  auto buffer = makeBuffer(config);
+
+  auto start = JitterBuffer::Clock::now();
+  buffer->push(0, frame('a'), start);
+  std::this_thread::sleep_for(40ms);
+  buffer->push(1, frame('b'), JitterBuffer::Clock::now());
+  buffer->drain();
+
+  auto stats = buffer->getStats();
+  EXPECT_EQ(stats.framesReleased, 2);
+  EXPECT_EQ(stats.underruns, 1);
+  EXPECT_EQ(stats.lateFrames, 1);
+  EXPECT_GE(stats.targetDelay, 30ms);
+}
+
+TEST_F(JitterBufferTest, ReordersWithinTheRing) {
+  JitterBufferConfig config;
+  config.interval = 1ms;
+  config.initialDelay = 5ms;
+  auto buffer = makeBuffer(config);
+
+  auto now = JitterBuffer::Clock::now();
+  buffer->push(0, frame('a'), now);
+  buffer->push(2, frame('c'), now);
+  buffer->push(1, frame('b'), now);
+  buffer->drain();
+
+  ASSERT_EQ(releases_.size(), 3);
+  EXPECT_EQ(releases_[1].frame, frame('b'));
+  EXPECT_EQ(releases_[2].frame, frame('c'));
+}
+
+TEST_F(JitterBufferTest, FullRingReleasesEarlyInsteadOfDropping) {
+  JitterBufferConfig config;
+  config.interval = 50ms;
+  config.capacity = 4;
+  auto buffer = makeBuffer(config);
+
+  auto now = JitterBuffer::Clock::now();
+  for (uint64_t sequence = 0; sequence < 10; ++sequence) {
+    buffer->push(sequence, frame(static_cast<char>('a' + sequence)), now);
+  }
+  auto stats = buffer->getStats();
+  EXPECT_EQ(stats.overflows, 6);
+  EXPECT_LE(stats.maxOccupancy, 4);
+  buffer.reset();
+
+  ASSERT_EQ(releases_.size(), 10);
+  for (size_t i = 0; i < releases_.size(); ++i) {
+    EXPECT_EQ(releases_[i].frame, frame(static_cast<char>('a' + i)));
+  }
+}
+
+TEST_F(JitterBufferTest, StopsPlayoutWhenTheInnerAcceptorThrows) {
+  class RejectingAcceptor : public PlayoutRecorder {
+  public:
+    using PlayoutRecorder::PlayoutRecorder;
+    void processRawData(const std::vector<char> &rawData,
+                        std::chrono::system_clock::time_point) override {
+      if (rawData[Constants::HeaderSizeBytes] == 'x') {
+        throw std::runtime_error("Data unit failed authentication");
+      }
+      PlayoutRecorder::processRawData(rawData);
+    }
+  };
+
+  JitterBufferConfig config;
+  config.interval = 1ms;
+  config.initialDelay = 1ms;
+  JitterBuffer buffer(std::make_unique<RejectingAcceptor>(releases_), config);
+  buffer.processRawData(frame('a'));
+  buffer.processRawData(frame('x'));
+  buffer.processRawData(frame('b'));
+
+  auto deadline = JitterBuffer::Clock::now() + 2s;
+  while (buffer.getStats().error.empty() &&
+         JitterBuffer::Clock::now() < deadline) {
+    std::this_thread::sleep_for(1ms);
+  }
+  auto stats = buffer.getStats();
+  EXPECT_EQ(stats.error, "Data unit failed authentication");
+  EXPECT_EQ(stats.framesReleased, 1);
+  EXPECT_EQ(buffer.getOccupancy(), 0);
+  // The receiver sees the failure on its next read.
+  EXPECT_THROW(buffer.processRawData(frame('c')), std::runtime_error);
+  buffer.drain();
+  ASSERT_EQ(releases_.size(), 1);
+  EXPECT_EQ(releases_[0].frame, frame('a'));
+}
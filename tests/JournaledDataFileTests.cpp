@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "CaptureJournal.hpp"
+#include "DataAcceptor.hpp"
+#include "DataFile.hpp"
+#include "JournaledDataFile.hpp"
+#include "TimestampWriter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+class JournaledDataFileTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    inputFileName_ = "../../resources/front_0.bin";
+    outputFileName_ = "journaled_data_file_test.bin";
+    timestampFileName_ = outputFileName_ + "_timestamps.txt";
+    crashFileName_ = "journaled_data_file_crash.bin";
+    DataFile input(inputFileName_);
+    while (auto unit = input.readNextDataUnit()) {
+      units_.push_back(unit.value());
+    }
+    ASSERT_EQ(units_.size(), 10u);
+  }
+
+  void TearDown() override {
+    for (const auto &name : {outputFileName_, crashFileName_}) {
+      std::filesystem::remove(name);
+      std::filesystem::remove(name + "_timestamps.txt");
+      std::filesystem::remove(CaptureJournal::journalPath(name));
+    }
+  }
+
+  static std::vector<char> readFile(const std::string &fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+  }
+
+  static size_t countLines(const std::string &fileName) {
+    std::ifstream file(fileName);
+    size_t lines = 0;
+    for (std::string line; std::getline(file, line);) {
+      lines++;
+    }
+    return lines;
+  }
+
+  std::unique_ptr<DataAcceptor> makeAcceptor(size_t commitFrames) {
+    return std::make_unique<DataAcceptor>(
+        std::make_unique<JournaledDataFile>(outputFileName_,
+                                            timestampFileName_, commitFrames,
+                                            std::chrono::hours(1)),
+        std::make_unique<TimestampWriter>(timestampFileName_));
+  }
+
+  std::string inputFileName_;
+  std::string outputFileName_;
+  std::string timestampFileName_;
+  std::string crashFileName_;
+  std::vector<std::vector<char>> units_;
+};
+
+TEST_F(JournaledDataFileTest, CleanCloseCommitsEverything) {
+  {
+    auto acceptor = makeAcceptor(4);
+    for (const auto &unit : units_) {
+      acceptor->processRawData(unit);
+    }
+  }
+
+  EXPECT_EQ(readFile(outputFileName_), readFile(inputFileName_));
+  auto commit = CaptureJournal::readLastCommit(outputFileName_);
+  ASSERT_TRUE(commit.has_value());
+  EXPECT_EQ(commit->frames, 10u);
+  EXPECT_EQ(commit->dataBytes, std::filesystem::file_size(outputFileName_));
+  EXPECT_EQ(commit->timestampBytes,
+            std::filesystem::file_size(timestampFileName_));
+  // Empty initial commit, after units 4 and 8, and on close.
+  EXPECT_EQ(commit->sequence, 4u);
+}
+
+TEST_F(JournaledDataFileTest, RecoversCommittedPrefixAfterCrash) {
+  auto acceptor = makeAcceptor(10);
+  for (int round = 0; round < 2; ++round) {
+    for (const auto &unit : units_) {
+      acceptor->processRawData(unit);
+    }
+  }
+  for (size_t i = 0; i < 5; ++i) {
+    acceptor->processRawData(units_[i]);
+  }
+  // Half a data unit, as if the receiver died mid-frame.
+  acceptor->processRawData(std::vector<char>(
+      units_[5].begin(), units_[5].begin() + units_[5].size() / 2));
+
+  // What the kernel holds at this point is what a crash would leave.
+  std::filesystem::copy_file(outputFileName_, crashFileName_);
+  std::filesystem::copy_file(timestampFileName_,
+                             crashFileName_ + "_timestamps.txt");
+  std::filesystem::copy_file(CaptureJournal::journalPath(outputFileName_),
+                             CaptureJournal::journalPath(crashFileName_));
+
+  auto recovery = CaptureJournal::recover(crashFileName_,
+                                          crashFileName_ + "_timestamps.txt");
+  ASSERT_TRUE(recovery.commit.has_value());
+  EXPECT_EQ(recovery.commit->frames, 20u);
+  // The timestamp log is flushed line by line, so it is always ahead.
+  EXPECT_TRUE(recovery.truncated);
+
+  DataFile recovered(crashFileName_);
+  size_t frames = 0;
+  while (auto unit = recovered.readNextDataUnit()) {
+    EXPECT_EQ(unit.value(), units_[frames % units_.size()]);
+    frames++;
+  }
+  EXPECT_EQ(frames, 20u);
+  EXPECT_EQ(countLines(crashFileName_ + "_timestamps.txt"), 20u);
+}
+
+TEST_F(JournaledDataFileTest, PreallocatesWithoutGrowingFile) {
+  {
+    JournaledDataFile file(outputFileName_, "", 1, std::chrono::hours(1),
+                           1 << 20);
+    file.writeBinaryData(units_[0]);
+#ifdef __linux__
+    if (file.getPreallocatedBytes() > 0) {
+      EXPECT_GE(file.getPreallocatedBytes(), 1u << 20);
+    }
+#endif
+  }
+  EXPECT_EQ(std::filesystem::file_size(outputFileName_), units_[0].size());
+}
+
+TEST_F(JournaledDataFileTest, CommitsLastUnitWhenStreamGoesQuiet) {
+  JournaledDataFile file(outputFileName_, timestampFileName_, 100,
+                         std::chrono::milliseconds(20));
+  std::ofstream log(timestampFileName_);
+  file.writeBinaryData(units_[0]);
+
+  // The unit is complete, but its log line is not written yet.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(CaptureJournal::readLastCommit(outputFileName_)->frames, 0u);
+
+  log << "unit 0" << std::endl;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (CaptureJournal::readLastCommit(outputFileName_)->frames == 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  auto commit = CaptureJournal::readLastCommit(outputFileName_);
+  EXPECT_EQ(commit->frames, 1u);
+  EXPECT_EQ(commit->dataBytes, units_[0].size());
+  EXPECT_EQ(commit->timestampBytes, 7u);
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "SendQueue.hpp"
+
+class SendQueueTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static std::shared_ptr<std::vector<char>> frame(char tag, size_t size = 8) {
+    return std::make_shared<std::vector<char>>(size, tag);
+  }
+
+  SendQueue::Clock::time_point start_ = SendQueue::Clock::now();
+};
+
+TEST_F(SendQueueTest, UnboundedQueuePreservesOrder) {
+  SendQueue queue;
+
+  for (char tag : {'a', 'b', 'c'}) {
+    EXPECT_TRUE(queue.push(frame(tag), false, start_));
+  }
+
+  for (char tag : {'a', 'b', 'c'}) {
+    auto entry = queue.pop(start_ + std::chrono::hours(1));
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->frame->front(), tag);
+  }
+  EXPECT_FALSE(queue.pop(start_).has_value());
+  EXPECT_EQ(queue.getDroppedFrames(), 0u);
+}
+
+TEST_F(SendQueueTest, OverflowDropsOldestDeltaFirst) {
+  SendQueue queue(2);
+
+  queue.push(frame('K'), true, start_);
+  queue.push(frame('a'), false, start_);
+  EXPECT_TRUE(queue.push(frame('b'), false, start_));
+
+  EXPECT_EQ(queue.size(), 2u);
+  EXPECT_EQ(queue.pop(start_)->frame->front(), 'K');
+  EXPECT_EQ(queue.pop(start_)->frame->front(), 'b');
+  EXPECT_EQ(queue.getDroppedFrames(), 1u);
+  EXPECT_EQ(queue.getDroppedBytes(), 8u);
+}
+
+TEST_F(SendQueueTest, OverflowNeverDropsKeyframes) {
+  SendQueue queue(1);
+
+  queue.push(frame('K'), true, start_);
+  EXPECT_FALSE(queue.push(frame('a', 5), false, start_));
+  EXPECT_TRUE(queue.push(frame('L'), true, start_));
+
+  EXPECT_EQ(queue.size(), 2u);
+  EXPECT_EQ(queue.getDroppedFrames(), 1u);
+  EXPECT_EQ(queue.getDroppedBytes(), 5u);
+}
+
+TEST_F(SendQueueTest, PopSkipsStaleDeltasButKeepsStaleKeyframes) {
+  SendQueue queue(0, std::chrono::milliseconds(50));
+
+  queue.push(frame('a'), false, start_);
+  queue.push(frame('K'), true, start_);
+  queue.push(frame('b'), false, start_ + std::chrono::milliseconds(40));
+
+  auto later = start_ + std::chrono::milliseconds(60);
+  EXPECT_EQ(queue.pop(later)->frame->front(), 'K');
+  EXPECT_EQ(queue.pop(later)->frame->front(), 'b');
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.getDroppedFrames(), 1u);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "SharedMemoryRing.hpp"
+#include "Constants.hpp"
+
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+class SharedMemoryRingTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+#ifndef __linux__
+    GTEST_SKIP() << "Shared-memory transport requires Linux futexes";
+#endif
+    segmentName_ = "/video_transport_test_" + std::to_string(getpid());
+    SharedMemoryRing::unlink(segmentName_);
+  }
+
+  void TearDown() override { SharedMemoryRing::unlink(segmentName_); }
+
+  static std::vector<char> frame(const std::string &payload) {
+    return std::vector<char>(payload.begin(), payload.end());
+  }
+
+  std::string segmentName_;
+};
+
+TEST_F(SharedMemoryRingTest, PublishAndConsumeInOrder) {
+  SharedMemoryRing consumer(segmentName_, SharedMemoryRing::Role::Consumer, 4);
+  std::thread producerThread([this]() {
+    SharedMemoryRing producer(segmentName_, SharedMemoryRing::Role::Producer);
+    for (int i = 0; i < 20; ++i) {
+      auto data = frame("frame" + std::to_string(i));
+      producer.publish(data.data(), data.size());
+    }
+    producer.finish();
+  });
+
+  std::vector<std::vector<char>> received;
+  while (auto data = consumer.consume()) {
+    received.push_back(data.value());
+  }
+  producerThread.join();
+
+  ASSERT_EQ(received.size(), 20);
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(received[i], frame("frame" + std::to_string(i)));
+  }
+  EXPECT_EQ(consumer.getReadSequence(), 20);
+}
+
+TEST_F(SharedMemoryRingTest, ResumesAfterRestarts) {
+  {
+    SharedMemoryRing producer(segmentName_, SharedMemoryRing::Role::Producer,
+                              8);
+    for (int i = 0; i < 3; ++i) {
+      auto data = frame("a" + std::to_string(i));
+      producer.publish(data.data(), data.size());
+    }
+  }
+  {
+    SharedMemoryRing consumer(segmentName_, SharedMemoryRing::Role::Consumer);
+    EXPECT_EQ(consumer.consume(), frame("a0"));
+    EXPECT_EQ(consumer.consume(), frame("a1"));
+  }
+
+  SharedMemoryRing producer(segmentName_, SharedMemoryRing::Role::Producer);
+  EXPECT_EQ(producer.getWriteSequence(), 3);
+  for (int i = 0; i < 2; ++i) {
+    auto data = frame("b" + std::to_string(i));
+    producer.publish(data.data(), data.size());
+  }
+  producer.finish();
+
+  SharedMemoryRing consumer(segmentName_, SharedMemoryRing::Role::Consumer);
+  EXPECT_EQ(consumer.getReadSequence(), 2);
+  EXPECT_EQ(consumer.consume(), frame("a2"));
+  EXPECT_EQ(consumer.consume(), frame("b0"));
+  EXPECT_EQ(consumer.consume(), frame("b1"));
+  EXPECT_FALSE(consumer.consume().has_value());
+}
+
+TEST_F(SharedMemoryRingTest, OversizedFrameThrows) {
+  SharedMemoryRing producer(segmentName_, SharedMemoryRing::Role::Producer);
+  std::vector<char> data(Constants::MaxPacketSize + 1, 'X');
+  EXPECT_THROW(producer.publish(data.data(), data.size()), std::runtime_error);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "DataFile.hpp"
+#include "DataProvider.hpp"
+#include "TimestampWriter.hpp"
+
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Fakes shared by the sender stage tests: a provider handing out a fixed
+// list of frames and sinks that collect or drop what an acceptor writes.
+class FrameListProvider : public IDataProvider {
+public:
+  explicit FrameListProvider(std::deque<std::vector<char>> frames)
+      : frames_(std::move(frames)) {}
+
+  std::optional<std::vector<char>> getNextData() override {
+    if (frames_.empty()) {
+      return std::nullopt;
+    }
+    auto frame = std::move(frames_.front());
+    frames_.pop_front();
+    return frame;
+  }
+  size_t prefetch(size_t) override { return 0; }
+
+private:
+  std::deque<std::vector<char>> frames_;
+};
+
+class CollectingDataFile : public IDataFile {
+public:
+  explicit CollectingDataFile(std::vector<std::vector<char>> &written)
+      : written_(written) {}
+  void writeBinaryData(const std::vector<char> &data) override {
+    written_.push_back(data);
+  }
+  std::optional<std::vector<char>> readNextDataUnit() override {
+    return std::nullopt;
+  }
+
+private:
+  std::vector<std::vector<char>> &written_;
+};
+
+class NullTimestampWriter : public ITimestampWriter {
+public:
+  void write(const DataUnit &) override {}
+  void write(const DataUnit &, std::chrono::system_clock::time_point) override {}
+  void open(const std::string &) override {}
+  void close() override {}
+};
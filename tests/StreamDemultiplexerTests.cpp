@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "StreamDemultiplexer.hpp"
+#include "DataUnitConverter.hpp"
+#include "Constants.hpp"
+
+#include <map>
+#include <memory>
+
+class RecordingAcceptor : public IDataAcceptor {
+public:
+  explicit RecordingAcceptor(std::vector<std::vector<char>> &units)
+      : units_(units) {}
+
+  void processRawData(const std::vector<char> &rawData) override {
+    units_.push_back(rawData);
+  }
+  void processRawData(const std::vector<char> &rawData,
+                      std::chrono::system_clock::time_point) override {
+    units_.push_back(rawData);
+  }
+  size_t getDataUnitsReceived() const override { return units_.size(); }
+  size_t getTotalBytesReceived() const override { return 0; }
+
+private:
+  std::vector<std::vector<char>> &units_;
+};
+
+class StreamDemultiplexerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    demultiplexer_ = std::make_unique<StreamDemultiplexer>(
+        [this](uint16_t streamId) -> std::unique_ptr<IDataAcceptor> {
+          return std::make_unique<RecordingAcceptor>(received_[streamId]);
+        });
+  }
+
+  std::vector<char> muxFrame(uint16_t streamId, const std::string &payload) {
+    DataUnit unit{static_cast<uint32_t>(payload.size()),
+                  std::vector<char>(payload.begin(), payload.end())};
+    std::vector<char> frame = {static_cast<char>(streamId >> 8),
+                               static_cast<char>(streamId & 0xFF)};
+    auto encoded = converter_.encodeDataUnit(unit);
+    frame.insert(frame.end(), encoded.begin(), encoded.end());
+    return frame;
+  }
+
+  DataUnitConverter converter_;
+  std::map<uint16_t, std::vector<std::vector<char>>> received_;
+  std::unique_ptr<StreamDemultiplexer> demultiplexer_;
+};
+
+TEST_F(StreamDemultiplexerTest, RoutesFramesByStreamId) {
+  std::vector<char> rawData;
+  for (auto frame : {muxFrame(0, "Hi"), muxFrame(7, "Camera"),
+                     muxFrame(0, "Again")}) {
+    rawData.insert(rawData.end(), frame.begin(), frame.end());
+  }
+
+  demultiplexer_->processRawData(rawData);
+
+  EXPECT_EQ(demultiplexer_->getStreamCount(), 2);
+  EXPECT_EQ(demultiplexer_->getDataUnitsReceived(), 3);
+  EXPECT_EQ(demultiplexer_->getTotalBytesReceived(), rawData.size());
+  ASSERT_EQ(received_[0].size(), 2);
+  ASSERT_EQ(received_[7].size(), 1);
+  EXPECT_EQ(received_[7][0], converter_.encodeDataUnit(
+                                 DataUnit{6, {'C', 'a', 'm', 'e', 'r', 'a'}}));
+  EXPECT_EQ(received_[0][1].size(), Constants::HeaderSizeBytes + 5);
+}
+
+TEST_F(StreamDemultiplexerTest, ReassemblesSplitFrames) {
+  auto frame = muxFrame(3, "Fragmented");
+
+  for (char byte : frame) {
+    demultiplexer_->processRawData(std::vector<char>{byte});
+  }
+
+  ASSERT_EQ(received_[3].size(), 1);
+  EXPECT_EQ(received_[3][0].size(),
+            frame.size() - Constants::StreamIdSizeBytes);
+  EXPECT_EQ(demultiplexer_->getStream(3)->getDataUnitsReceived(), 1);
+  EXPECT_EQ(demultiplexer_->getStream(4), nullptr);
+}
+
+TEST_F(StreamDemultiplexerTest, RejectsReservedFlags) {
+  auto frame = muxFrame(1, "Corrupt");
+  frame[Constants::StreamIdSizeBytes] = 0x20;
+
+  EXPECT_THROW(demultiplexer_->processRawData(frame), std::runtime_error);
+  EXPECT_EQ(demultiplexer_->getDataUnitsReceived(), 0u);
+}
+
+TEST_F(StreamDemultiplexerTest, RejectsOversizedLength) {
+  std::vector<char> frame = {0x00, 0x01, 0x00, 0x7F, 0x00, 0x00};
+
+  EXPECT_THROW(demultiplexer_->processRawData(frame), std::runtime_error);
+  EXPECT_EQ(demultiplexer_->getDataUnitsReceived(), 0u);
+}
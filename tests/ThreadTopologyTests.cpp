@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "ThreadTopology.hpp"
+
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+class ThreadTopologyTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(ThreadTopologyTest, ParsesCpuLists) {
+  EXPECT_EQ(ThreadTopology::parseCpuList("3"), std::vector<int>({3}));
+  EXPECT_EQ(ThreadTopology::parseCpuList("0-2,5,7-8"),
+            std::vector<int>({0, 1, 2, 5, 7, 8}));
+  EXPECT_EQ(ThreadTopology::parseCpuList("4,1-2,2"),
+            std::vector<int>({1, 2, 4}));
+  EXPECT_THROW(ThreadTopology::parseCpuList("5-2"), std::runtime_error);
+  EXPECT_THROW(ThreadTopology::parseCpuList(""), std::runtime_error);
+}
+
+TEST_F(ThreadTopologyTest, ParsesStagesAndNodes) {
+  auto topology = ThreadTopology::parse("io:0/playout:node0");
+
+  EXPECT_EQ(topology.io.cpus, std::vector<int>({0}));
+  EXPECT_EQ(topology.io.numaNode, ThreadTopology::nodeOfCpu(0));
+  EXPECT_TRUE(topology.workers.empty());
+  EXPECT_EQ(topology.playout.numaNode, 0);
+  EXPECT_EQ(topology.playout.cpus, ThreadTopology::cpusOfNode(0));
+  EXPECT_TRUE(ThreadTopology::parse("").io.empty());
+}
+
+TEST_F(ThreadTopologyTest, RejectsUnknownStages) {
+  EXPECT_THROW(ThreadTopology::parse("gpu:0"), std::runtime_error);
+  EXPECT_THROW(ThreadTopology::parse("io"), std::runtime_error);
+  EXPECT_THROW(ThreadTopology::parse("io:node999"), std::runtime_error);
+}
+
+#ifdef __linux__
+TEST_F(ThreadTopologyTest, PinsTheCallingThread) {
+  auto topology = ThreadTopology::parse("workers:0");
+  cpu_set_t cpus;
+  std::thread worker([&]() {
+    topology.apply(ThreadTopology::Role::Workers);
+    sched_getaffinity(0, sizeof(cpus), &cpus);
+  });
+  worker.join();
+
+  EXPECT_EQ(CPU_COUNT(&cpus), 1);
+  EXPECT_TRUE(CPU_ISSET(0, &cpus));
+}
+
+TEST_F(ThreadTopologyTest, UnplacedStagesDoNotInheritTheIoPlacement) {
+  std::thread main([]() {
+    auto topology = ThreadTopology::parse("io:node0");
+    auto before = ThreadTopology::currentThreadState();
+    topology.apply(ThreadTopology::Role::Io);
+    if (ThreadTopology::currentThreadState().memoryPolicy ==
+        before.memoryPolicy) {
+      return; // the platform refused the policy; nothing to undo
+    }
+
+    ThreadTopology::ThreadState worker;
+    std::thread spawned([&]() {
+      topology.apply(ThreadTopology::Role::Workers);
+      worker = ThreadTopology::currentThreadState();
+    });
+    spawned.join();
+    EXPECT_EQ(worker.memoryPolicy, before.memoryPolicy);
+    EXPECT_EQ(worker.nodeMask, before.nodeMask);
+    EXPECT_EQ(worker.cpus, before.cpus);
+  });
+  main.join();
+}
+
+TEST_F(ThreadTopologyTest, IgnoresCpusAndNodesOutOfRange) {
+  std::thread worker([]() {
+    auto before = ThreadTopology::currentThreadState();
+    ThreadTopology topology;
+    topology.workers.cpus = {CPU_SETSIZE};
+    topology.workers.numaNode = 64;
+    topology.apply(ThreadTopology::Role::Workers);
+
+    auto after = ThreadTopology::currentThreadState();
+    EXPECT_EQ(after.cpus, before.cpus);
+    EXPECT_EQ(after.memoryPolicy, before.memoryPolicy);
+  });
+  worker.join();
+}
+#endif
+
+TEST_F(ThreadTopologyTest, BenchmarkReportsEveryNodePair) {
+  auto topology = ThreadTopology::parse("io:0/workers:0");
+  std::stringstream out;
+
+  topology.runBenchmark(out, 1024 * 1024);
+
+  EXPECT_NE(out.str().find("NUMA nodes: " +
+                           std::to_string(ThreadTopology::nodeCount())),
+            std::string::npos);
+  EXPECT_NE(out.str().find("node0"), std::string::npos);
+  EXPECT_NE(out.str().find("Hand-off io -> workers"), std::string::npos);
+  EXPECT_EQ(out.str().find("Hand-off io -> playout"), std::string::npos);
+}
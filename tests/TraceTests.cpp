@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include "Trace.hpp"
+
+#include <sstream>
+#include <thread>
+
+class TraceTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(TraceTest, BufferKeepsEventsInOrder) {
+  TraceBuffer buffer(1, "test");
+
+  buffer.record("first", 100, 5, 'X');
+  buffer.record("second", 200, 0, 'B');
+
+  auto events = buffer.snapshot();
+  ASSERT_EQ(events.size(), 2);
+  EXPECT_STREQ(events[0].name, "first");
+  EXPECT_EQ(events[0].startNs, 100);
+  EXPECT_EQ(events[0].durationNs, 5);
+  EXPECT_EQ(events[1].phase, 'B');
+}
+
+TEST_F(TraceTest, BufferRetainsNewestEventsWhenFull) {
+  auto buffer = std::make_unique<TraceBuffer>(1, "test");
+
+  for (uint64_t i = 0; i < TraceBuffer::Capacity + 10; ++i) {
+    buffer->record("event", i, 1, 'X');
+  }
+
+  // The oldest slot is the next one the owner writes, so it is left out.
+  auto events = buffer->snapshot();
+  ASSERT_EQ(events.size(), TraceBuffer::Capacity - 1);
+  EXPECT_EQ(events.front().startNs, 11);
+  EXPECT_EQ(events.back().startNs, TraceBuffer::Capacity + 9);
+}
+
+TEST_F(TraceTest, ExportsChromeTraceForEveryThread) {
+  std::thread worker([]() {
+    Tracer::instance().setThreadName("worker");
+    TraceScope scope("workerScope");
+  });
+  worker.join();
+  {
+    TraceScope scope("mainScope");
+  }
+
+  std::ostringstream json;
+  Tracer::instance().writeChromeTrace(json);
+  std::string trace = json.str();
+
+  EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+  EXPECT_NE(trace.find("\"name\":\"workerScope\",\"ph\":\"X\""),
+            std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"mainScope\""), std::string::npos);
+  EXPECT_NE(trace.find("\"args\":{\"name\":\"worker\"}"), std::string::npos);
+  EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+}
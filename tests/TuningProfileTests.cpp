@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "TuningProfile.hpp"
+
+#include <algorithm>
+#include <boost/asio.hpp>
+#include <fstream>
+#include <stdexcept>
+
+using boost::asio::ip::tcp;
+
+class TuningProfileTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  // The kernel caps an unprivileged request at net.core.[wr]mem_max.
+  static int expectedBufferBytes(int requested, const std::string &limitFile) {
+    std::ifstream file(limitFile);
+    int limit = 0;
+    if (file >> limit && limit > 0) {
+      return std::min(requested, limit);
+    }
+    return requested;
+  }
+};
+
+TEST_F(TuningProfileTest, DefaultProfileChangesNothing) {
+  auto profile = TuningProfile::fromName("default");
+
+  EXPECT_EQ(profile.name, "default");
+  EXPECT_EQ(profile.sendBufferBytes, 0);
+  EXPECT_EQ(profile.receiveBufferBytes, 0);
+  EXPECT_EQ(profile.busyPollMicros, 0);
+  EXPECT_FALSE(profile.quickAck);
+  EXPECT_FALSE(profile.zeroCopy);
+  EXPECT_FALSE(profile.kernelTimestamps);
+  EXPECT_EQ(profile.cpuAffinity, -1);
+  EXPECT_EQ(profile.fifoPriority, 0);
+}
+
+TEST_F(TuningProfileTest, NamedProfiles) {
+  auto latency = TuningProfile::fromName("latency");
+  EXPECT_TRUE(latency.quickAck);
+  EXPECT_TRUE(latency.kernelTimestamps);
+  EXPECT_GT(latency.busyPollMicros, 0);
+
+  auto throughput = TuningProfile::fromName("throughput");
+  EXPECT_TRUE(throughput.zeroCopy);
+  EXPECT_GT(throughput.sendBufferBytes, 0);
+  EXPECT_GT(throughput.receiveBufferBytes, 0);
+}
+
+TEST_F(TuningProfileTest, UnknownProfileThrows) {
+  EXPECT_THROW(TuningProfile::fromName("turbo"), std::runtime_error);
+}
+
+TEST_F(TuningProfileTest, ApplyBufferSizesToSocket) {
+  boost::asio::io_context ioContext;
+  tcp::socket socket(ioContext);
+  socket.open(tcp::v4());
+
+  TuningProfile profile;
+  profile.sendBufferBytes = 256 * 1024;
+  profile.receiveBufferBytes = 256 * 1024;
+  profile.applySocketOptions(socket);
+
+  boost::asio::socket_base::send_buffer_size sendBuffer;
+  boost::asio::socket_base::receive_buffer_size receiveBuffer;
+  socket.get_option(sendBuffer);
+  socket.get_option(receiveBuffer);
+
+  // Linux doubles the (capped) request to leave room for bookkeeping.
+  EXPECT_GE(sendBuffer.value(),
+            expectedBufferBytes(profile.sendBufferBytes,
+                                "/proc/sys/net/core/wmem_max"));
+  EXPECT_GE(receiveBuffer.value(),
+            expectedBufferBytes(profile.receiveBufferBytes,
+                                "/proc/sys/net/core/rmem_max"));
+}
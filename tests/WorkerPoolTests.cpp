@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "WorkerPool.hpp"
+
+#include <atomic>
+
+class WorkerPoolTest : public ::testing::Test {
+protected:
+  void SetUp() override {}
+  void TearDown() override {}
+};
+
+TEST_F(WorkerPoolTest, ReturnsResultsThroughFutures) {
+  WorkerPool pool(3);
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 20; ++i) {
+    results.push_back(pool.submit([i]() { return i * i; }));
+  }
+
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(results[i].get(), i * i);
+  }
+  EXPECT_EQ(pool.getThreadCount(), 3u);
+}
+
+TEST_F(WorkerPoolTest, RunsQueuedTasksBeforeShutdown) {
+  std::atomic<int> completed{0};
+  {
+    WorkerPool pool(1);
+    for (int i = 0; i < 50; ++i) {
+      pool.submit([&completed]() { ++completed; });
+    }
+  }
+  EXPECT_EQ(completed.load(), 50);
+}
+
+TEST_F(WorkerPoolTest, PropagatesExceptions) {
+  WorkerPool pool(1);
+  auto result = pool.submit([]() -> int { throw std::runtime_error("boom"); });
+
+  EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST_F(WorkerPoolTest, RunsThreadInitOnEveryWorker) {
+  std::atomic<int> initialised{0};
+  {
+    WorkerPool pool(3, [&initialised]() { initialised++; });
+    pool.submit([]() { return 0; }).get();
+  }
+  EXPECT_EQ(initialised.load(), 3);
+}